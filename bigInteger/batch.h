@@ -0,0 +1,433 @@
+#pragma once
+
+#include "biginteger.h"
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Batch evaluation of independent expression trees over BigInteger or Rational. Expressions
+// are built through the batch, which hash-conses every node: a constant or an operation on
+// the same operands is stored once, so common subexpressions across the whole batch are
+// evaluated once. evaluate() runs the DAG on a work-stealing pool and returns the submitted
+// roots' values in submission order.
+template <typename T>
+class Batch
+{
+    static_assert(std::is_same<T, BigInteger>::value || std::is_same<T, Rational>::value,
+                  "Batch supports BigInteger and Rational expressions");
+
+public:
+    // Handle of a node, only meaningful for the batch that created it
+    using Expr = size_t;
+
+private:
+    enum class Op : uint8_t
+    {
+        Constant,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Neg
+    };
+
+    struct Node
+    {
+        Op op;
+        size_t lhs, rhs; // operand nodes, or the index into constants_ for Op::Constant
+    };
+
+    struct NodeKey
+    {
+        Op op;
+        size_t lhs, rhs;
+
+        bool operator==(const NodeKey &x) const
+        {
+            return op == x.op && lhs == x.lhs && rhs == x.rhs;
+        }
+    };
+
+    struct NodeKeyHash
+    {
+        size_t operator()(const NodeKey &x) const
+        {
+            uint64_t h = (static_cast<uint64_t>(x.lhs) * 0x9e3779b97f4a7c15ULL) ^ x.rhs;
+            h = (h ^ (h >> 31)) * 0xbf58476d1ce4e5b9ULL + static_cast<uint64_t>(x.op);
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    // Per-worker deque: the owner pushes and pops at the back, thieves take from the front
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<Expr> items;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<T> constants_;
+    std::vector<Expr> roots_;
+    std::unordered_map<T, Expr> constantIndex_;
+    std::unordered_map<NodeKey, Expr, NodeKeyHash> nodeIndex_;
+
+    Expr check(Expr e) const
+    {
+        if (e >= nodes_.size())
+        {
+            throw std::out_of_range("Batch: unknown expression");
+        }
+        return e;
+    }
+
+    Expr intern(Op op, Expr lhs, Expr rhs)
+    {
+        NodeKey key{op, check(lhs), check(rhs)};
+        if ((op == Op::Add || op == Op::Mul) && key.lhs > key.rhs)
+        {
+            std::swap(key.lhs, key.rhs);
+        }
+        auto it = nodeIndex_.find(key);
+        if (it != nodeIndex_.end())
+        {
+            return it->second;
+        }
+        nodes_.push_back(Node{op, key.lhs, key.rhs});
+        nodeIndex_.emplace(key, nodes_.size() - 1);
+        return nodes_.size() - 1;
+    }
+
+    // State shared by the workers of one evaluate() call. Operands always precede their
+    // users in nodes_, so a node becomes ready once its pending count drops to zero.
+    struct Run
+    {
+        const Batch &batch;
+        std::vector<T> values;
+        std::vector<size_t> userOffsets, users;         // users of each node, CSR layout
+        std::vector<std::atomic<size_t>> pending, uses; // unfinished operands, unfinished users
+        std::vector<char> isRoot;
+        std::atomic<size_t> remaining{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        Run(const Batch &b, size_t n) : batch(b), values(n), userOffsets(n + 1, 0), pending(n), uses(n), isRoot(n, 0)
+        {
+        }
+
+        void compute(Expr e)
+        {
+            const Node &node = batch.nodes_[e];
+            T &res = values[e];
+            switch (node.op)
+            {
+            case Op::Constant:
+                res = batch.constants_[node.lhs];
+                return;
+            case Op::Neg:
+                res = -values[node.lhs];
+                break;
+            case Op::Add:
+                res = values[node.lhs];
+                res += values[node.rhs];
+                break;
+            case Op::Sub:
+                res = values[node.lhs];
+                res -= values[node.rhs];
+                break;
+            case Op::Mul:
+                res = values[node.lhs];
+                res *= values[node.rhs];
+                break;
+            case Op::Div:
+                if (values[node.rhs] == 0)
+                {
+                    throw std::domain_error("Batch: division by zero");
+                }
+                res = values[node.lhs];
+                res /= values[node.rhs];
+                break;
+            }
+            // intermediates are released as soon as their last user has read them
+            release(node.lhs);
+            if (node.op != Op::Neg)
+            {
+                release(node.rhs);
+            }
+        }
+
+        void release(Expr e)
+        {
+            if (uses[e].fetch_sub(1) == 1 && !isRoot[e])
+            {
+                values[e] = T();
+            }
+        }
+
+        void fail()
+        {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            failed = true;
+        }
+    };
+
+    static void work(Run &run, std::vector<WorkQueue> &queues, size_t id)
+    {
+        WorkQueue &own = queues[id];
+        while (run.remaining.load(std::memory_order_acquire) > 0 && !run.failed.load(std::memory_order_relaxed))
+        {
+            Expr e = 0;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (!own.items.empty())
+                {
+                    e = own.items.back();
+                    own.items.pop_back();
+                    found = true;
+                }
+            }
+            for (size_t k = 1; !found && k < queues.size(); ++k)
+            {
+                WorkQueue &victim = queues[(id + k) % queues.size()];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.items.empty())
+                {
+                    e = victim.items.front();
+                    victim.items.pop_front();
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            try
+            {
+                run.compute(e);
+            }
+            catch (...)
+            {
+                run.fail();
+                return;
+            }
+            for (size_t u = run.userOffsets[e]; u < run.userOffsets[e + 1]; ++u)
+            {
+                Expr user = run.users[u];
+                if (run.pending[user].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::lock_guard<std::mutex> guard(own.lock);
+                    own.items.push_back(user);
+                }
+            }
+            run.remaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+public:
+    Expr constant(const T &value)
+    {
+        auto it = constantIndex_.find(value);
+        if (it != constantIndex_.end())
+        {
+            return it->second;
+        }
+        constants_.push_back(value);
+        nodes_.push_back(Node{Op::Constant, constants_.size() - 1, 0});
+        constantIndex_.emplace(value, nodes_.size() - 1);
+        return nodes_.size() - 1;
+    }
+
+    Expr add(Expr a, Expr b)
+    {
+        return intern(Op::Add, a, b);
+    }
+
+    Expr subtract(Expr a, Expr b)
+    {
+        return intern(Op::Sub, a, b);
+    }
+
+    Expr multiply(Expr a, Expr b)
+    {
+        return intern(Op::Mul, a, b);
+    }
+
+    // Division of BigIntegers truncates like BigInteger::operator/
+    Expr divide(Expr a, Expr b)
+    {
+        return intern(Op::Div, a, b);
+    }
+
+    Expr negate(Expr a)
+    {
+        return intern(Op::Neg, a, a);
+    }
+
+    // Queues a root for evaluation and returns its position in the result vector
+    size_t submit(Expr root)
+    {
+        roots_.push_back(check(root));
+        return roots_.size() - 1;
+    }
+
+    // Number of submitted roots
+    size_t size() const
+    {
+        return roots_.size();
+    }
+
+    // Number of distinct nodes after deduplication
+    size_t nodeCount() const
+    {
+        return nodes_.size();
+    }
+
+    void clear()
+    {
+        nodes_.clear();
+        constants_.clear();
+        roots_.clear();
+        constantIndex_.clear();
+        nodeIndex_.clear();
+    }
+
+    // Evaluates every node reachable from the submitted roots on `threads` workers (0 means
+    // std::thread::hardware_concurrency()). The first exception thrown by an operation, e.g.
+    // std::domain_error on division by zero, is rethrown here. The batch itself is unchanged
+    // and can be evaluated again.
+    std::vector<T> evaluate(size_t threads = 0) const
+    {
+        size_t n = nodes_.size();
+        std::vector<char> reachable(n, 0);
+        for (Expr r : roots_)
+        {
+            reachable[r] = 1;
+        }
+        size_t count = 0;
+        for (size_t i = n; i > 0; --i)
+        {
+            if (reachable[i - 1])
+            {
+                ++count;
+                const Node &node = nodes_[i - 1];
+                if (node.op != Op::Constant)
+                {
+                    reachable[node.lhs] = reachable[node.rhs] = 1;
+                }
+            }
+        }
+
+        Run run(*this, n);
+        for (Expr r : roots_)
+        {
+            run.isRoot[r] = 1;
+        }
+        std::vector<size_t> uses(n, 0), pending(n, 0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Node &node = nodes_[i];
+            if (!reachable[i] || node.op == Op::Constant)
+            {
+                continue;
+            }
+            ++uses[node.lhs];
+            ++pending[i];
+            if (node.op != Op::Neg)
+            {
+                ++uses[node.rhs];
+                ++pending[i];
+            }
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            run.userOffsets[i + 1] = run.userOffsets[i] + uses[i];
+            run.uses[i].store(uses[i], std::memory_order_relaxed);
+            run.pending[i].store(pending[i], std::memory_order_relaxed);
+        }
+        run.users.resize(run.userOffsets[n]);
+        std::vector<size_t> fill(run.userOffsets.begin(), run.userOffsets.end() - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Node &node = nodes_[i];
+            if (!reachable[i] || node.op == Op::Constant)
+            {
+                continue;
+            }
+            run.users[fill[node.lhs]++] = i;
+            if (node.op != Op::Neg)
+            {
+                run.users[fill[node.rhs]++] = i;
+            }
+        }
+
+        if (threads == 0)
+        {
+            threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        threads = std::min(threads, std::max<size_t>(count, 1));
+        if (threads == 1)
+        {
+            // nodes_ is already in dependency order
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (reachable[i])
+                {
+                    run.compute(i);
+                }
+            }
+        }
+        else
+        {
+            std::vector<WorkQueue> queues(threads);
+            size_t next = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (reachable[i] && nodes_[i].op == Op::Constant)
+                {
+                    queues[next++ % threads].items.push_back(i);
+                }
+            }
+            run.remaining = count;
+            std::vector<std::thread> workers;
+            for (size_t id = 1; id < threads; ++id)
+            {
+                workers.emplace_back([&run, &queues, id]() { work(run, queues, id); });
+            }
+            work(run, queues, 0);
+            for (std::thread &w : workers)
+            {
+                w.join();
+            }
+            if (run.error)
+            {
+                std::rethrow_exception(run.error);
+            }
+        }
+
+        std::vector<size_t> left(n, 0);
+        for (Expr r : roots_)
+        {
+            ++left[r];
+        }
+        std::vector<T> res;
+        res.reserve(roots_.size());
+        for (Expr r : roots_)
+        {
+            res.push_back(--left[r] == 0 ? std::move(run.values[r]) : run.values[r]);
+        }
+        return res;
+    }
+};
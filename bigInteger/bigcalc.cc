@@ -0,0 +1,120 @@
+// bigcalc: evaluates one expression per stdin line and prints one result per line.
+//
+//   bigcalc [-q] [--rpn] [-j threads] [-b lines]
+//
+//   -q       exact rational arithmetic (default: BigInteger, / truncates)
+//   --rpn    reverse Polish input instead of infix
+//   -j N     worker threads per block of lines (0 = all cores, default 1)
+//   -b N     lines evaluated together as one batch (default 4096)
+//
+// Input is read in 1 MiB chunks and processed a block of lines at a time, so memory stays
+// bounded by the block size whatever the length of the stream. Results keep input order.
+#include "calculator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+constexpr size_t kChunkBytes = 1 << 20;
+
+struct Options
+{
+    bool rational = false;
+    bool rpn = false;
+    size_t threads = 1;
+    size_t blockLines = 4096;
+};
+
+[[noreturn]] void usage()
+{
+    std::fputs("usage: bigcalc [-q] [--rpn] [-j threads] [-b lines]\n", stderr);
+    std::exit(2);
+}
+
+size_t parseCount(const char *arg)
+{
+    char *end = nullptr;
+    unsigned long long n = std::strtoull(arg, &end, 10);
+    if (end == arg || *end != '\0')
+    {
+        usage();
+    }
+    return static_cast<size_t>(n);
+}
+
+template <typename T>
+int run(const Options &options)
+{
+    Calculator<T> calculator(options.rpn ? Calculator<T>::Syntax::Rpn : Calculator<T>::Syntax::Infix,
+                             options.threads);
+    std::vector<char> chunk(kChunkBytes);
+    std::string pending, out;
+    std::vector<std::string_view> lines;
+
+    // lines point into `pending`, which only changes between flushes
+    auto flush = [&]() {
+        out.clear();
+        calculator.evaluate(lines, out);
+        lines.clear();
+        std::fwrite(out.data(), 1, out.size(), stdout);
+    };
+
+    size_t read;
+    while ((read = std::fread(chunk.data(), 1, chunk.size(), stdin)) > 0)
+    {
+        pending.append(chunk.data(), read);
+        size_t start = 0;
+        for (size_t nl = pending.find('\n'); nl != std::string::npos; nl = pending.find('\n', start))
+        {
+            lines.emplace_back(pending.data() + start, nl - start);
+            start = nl + 1;
+            if (lines.size() == options.blockLines)
+            {
+                flush();
+            }
+        }
+        flush();
+        pending.erase(0, start);
+    }
+    if (!pending.empty())
+    {
+        lines.emplace_back(pending);
+    }
+    flush();
+    std::fflush(stdout);
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-q") == 0)
+        {
+            options.rational = true;
+        }
+        else if (std::strcmp(argv[i], "--rpn") == 0)
+        {
+            options.rpn = true;
+        }
+        else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            options.threads = parseCount(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            options.blockLines = std::max<size_t>(parseCount(argv[++i]), 1);
+        }
+        else
+        {
+            usage();
+        }
+    }
+    return options.rational ? run<Rational>(options) : run<BigInteger>(options);
+}
@@ -0,0 +1,498 @@
+#pragma once
+
+#include "biginteger.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+enum class RoundingMode
+{
+    HalfEven, // to nearest, ties to the even neighbour
+    HalfUp,   // to nearest, ties away from zero
+    HalfDown, // to nearest, ties toward zero
+    Up,       // away from zero
+    Down,     // toward zero (truncation)
+    Ceiling,  // toward +infinity
+    Floor     // toward -infinity
+};
+
+// Decimal fixed-point number mantissa * 10^-scale. Since BigInteger stores decimal digits,
+// rescaling is a digit shift and string conversion is linear; only division rounds, to
+// the scale given by the caller or to the per-thread default.
+class BigDecimal
+{
+private:
+    BigInteger mantissa_;
+    int32_t scale_ = 0;
+
+    struct DivisionContext
+    {
+        int32_t scale = 20;
+        RoundingMode mode = RoundingMode::HalfEven;
+    };
+
+    static DivisionContext &context()
+    {
+        thread_local DivisionContext ctx;
+        return ctx;
+    }
+
+    static int32_t checkedScale(int64_t scale)
+    {
+        if (scale > std::numeric_limits<int32_t>::max() || scale < std::numeric_limits<int32_t>::min())
+        {
+            throw std::overflow_error("BigDecimal: scale out of range");
+        }
+        return static_cast<int32_t>(scale);
+    }
+
+    // whether the truncated |q| has to grow by one; half compares the discarded part with
+    // one half of the last kept unit (-1, 0 or 1)
+    static bool roundsAway(RoundingMode mode, bool negative, int half, bool inexact, bool odd)
+    {
+        if (!inexact)
+        {
+            return false;
+        }
+        switch (mode)
+        {
+        case RoundingMode::HalfEven:
+            return half > 0 || (half == 0 && odd);
+        case RoundingMode::HalfUp:
+            return half >= 0;
+        case RoundingMode::HalfDown:
+            return half > 0;
+        case RoundingMode::Up:
+            return true;
+        case RoundingMode::Down:
+            return false;
+        case RoundingMode::Ceiling:
+            return !negative;
+        case RoundingMode::Floor:
+            return negative;
+        }
+        return false;
+    }
+
+    static void roundAway(BigInteger &q, bool negative)
+    {
+        if (negative)
+        {
+            q -= 1;
+        }
+        else
+        {
+            q += 1;
+        }
+    }
+
+    // brings x to the scale of y when y's is larger, without rounding
+    static void alignScales(BigDecimal &x, BigDecimal &y)
+    {
+        if (x.scale_ < y.scale_)
+        {
+            x.mantissa_.multiplyPow10(static_cast<size_t>(int64_t(y.scale_) - x.scale_));
+            x.scale_ = y.scale_;
+        }
+        else if (y.scale_ < x.scale_)
+        {
+            y.mantissa_.multiplyPow10(static_cast<size_t>(int64_t(x.scale_) - y.scale_));
+            y.scale_ = x.scale_;
+        }
+    }
+
+public:
+    BigDecimal() : mantissa_(0)
+    {
+    }
+
+    BigDecimal(int64_t x) : mantissa_(x)
+    {
+    }
+
+    BigDecimal(BigInteger mantissa, int32_t scale = 0) : mantissa_(std::move(mantissa)), scale_(scale)
+    {
+    }
+
+    // Plain or scientific notation: [+-]digits[.digits][(e|E)[+-]digits]
+    explicit BigDecimal(const std::string &s)
+    {
+        size_t pos = 0;
+        std::string digits;
+        digits.reserve(s.size() + 1);
+        if (pos < s.size() && (s[pos] == '-' || s[pos] == '+'))
+        {
+            if (s[pos] == '-')
+            {
+                digits.push_back('-');
+            }
+            ++pos;
+        }
+        size_t count = 0;
+        int64_t scale = 0;
+        bool point = false;
+        for (; pos < s.size() && s[pos] != 'e' && s[pos] != 'E'; ++pos)
+        {
+            if (s[pos] == '.' && !point)
+            {
+                point = true;
+            }
+            else if (s[pos] >= '0' && s[pos] <= '9')
+            {
+                digits.push_back(s[pos]);
+                ++count;
+                scale += point;
+            }
+            else
+            {
+                throw std::invalid_argument("BigDecimal: invalid character");
+            }
+        }
+        if (count == 0)
+        {
+            throw std::invalid_argument("BigDecimal: no digits");
+        }
+        if (pos < s.size())
+        {
+            ++pos;
+            bool negative = pos < s.size() && s[pos] == '-';
+            if (pos < s.size() && (s[pos] == '-' || s[pos] == '+'))
+            {
+                ++pos;
+            }
+            if (pos == s.size())
+            {
+                throw std::invalid_argument("BigDecimal: no exponent digits");
+            }
+            int64_t exponent = 0;
+            for (; pos < s.size(); ++pos)
+            {
+                if (s[pos] < '0' || s[pos] > '9')
+                {
+                    throw std::invalid_argument("BigDecimal: invalid exponent");
+                }
+                exponent = exponent * 10 + (s[pos] - '0');
+                if (exponent > std::numeric_limits<int32_t>::max())
+                {
+                    throw std::overflow_error("BigDecimal: scale out of range");
+                }
+            }
+            scale -= negative ? -exponent : exponent;
+        }
+        mantissa_ = BigInteger::fromString(digits);
+        scale_ = checkedScale(scale);
+    }
+
+    // Default scale and rounding of operator/ and operator/=. The setting is per thread.
+    static void setDivisionScale(int32_t scale, RoundingMode mode = RoundingMode::HalfEven)
+    {
+        context().scale = scale;
+        context().mode = mode;
+    }
+
+    static int32_t getDivisionScale()
+    {
+        return context().scale;
+    }
+
+    static RoundingMode getDivisionRounding()
+    {
+        return context().mode;
+    }
+
+    const BigInteger &getMantissa() const
+    {
+        return mantissa_;
+    }
+
+    int32_t getScale() const
+    {
+        return scale_;
+    }
+
+    // The same value with `scale` digits after the point, rounded when digits are dropped
+    BigDecimal withScale(int32_t scale, RoundingMode mode = RoundingMode::HalfEven) const
+    {
+        BigDecimal res = *this;
+        if (scale >= scale_)
+        {
+            res.mantissa_.multiplyPow10(static_cast<size_t>(int64_t(scale) - scale_));
+            res.scale_ = scale;
+            return res;
+        }
+        size_t drop = static_cast<size_t>(int64_t(scale_) - scale);
+        const BigIntegerDigits &digits = mantissa_.getDigits();
+        int half = -1;
+        bool inexact = false;
+        if (drop <= digits.size())
+        {
+            uint16_t top = digits[drop - 1];
+            bool rest = false;
+            for (size_t i = 0; i + 1 < drop && !rest; ++i)
+            {
+                rest = digits[i] != 0;
+            }
+            half = (top > 5 || (top == 5 && rest)) ? 1 : ((top == 5) ? 0 : -1);
+            inexact = top != 0 || rest;
+        }
+        else
+        {
+            inexact = mantissa_ != 0;
+        }
+        bool negative = !mantissa_.getSign();
+        res.mantissa_.dividePow10(drop);
+        res.scale_ = scale;
+        if (roundsAway(mode, negative, half, inexact, res.mantissa_.lastDigit() % 2 != 0))
+        {
+            roundAway(res.mantissa_, negative);
+        }
+        return res;
+    }
+
+    // Drops trailing zeros of the mantissa, 0 gets scale 0
+    BigDecimal stripTrailingZeros() const
+    {
+        if (mantissa_ == 0)
+        {
+            return BigDecimal();
+        }
+        const BigIntegerDigits &digits = mantissa_.getDigits();
+        size_t zeros = 0;
+        while (digits[zeros] == 0)
+        {
+            ++zeros;
+        }
+        BigDecimal res = *this;
+        res.mantissa_.dividePow10(zeros);
+        res.scale_ = checkedScale(int64_t(scale_) - static_cast<int64_t>(zeros));
+        return res;
+    }
+
+    BigDecimal operator-() const
+    {
+        return BigDecimal(-mantissa_, scale_);
+    }
+
+    BigDecimal &operator+=(const BigDecimal &x)
+    {
+        BigDecimal y = x;
+        alignScales(*this, y);
+        mantissa_ += y.mantissa_;
+        return *this;
+    }
+
+    BigDecimal &operator-=(const BigDecimal &x)
+    {
+        BigDecimal y = x;
+        alignScales(*this, y);
+        mantissa_ -= y.mantissa_;
+        return *this;
+    }
+
+    // exact: the scales add up
+    BigDecimal &operator*=(const BigDecimal &x)
+    {
+        mantissa_ *= x.mantissa_;
+        scale_ = checkedScale(int64_t(scale_) + x.scale_);
+        return *this;
+    }
+
+    BigDecimal &operator/=(const BigDecimal &x)
+    {
+        *this = divide(x, context().scale, context().mode);
+        return *this;
+    }
+
+    // *this / x rounded to `scale` digits after the point
+    BigDecimal divide(const BigDecimal &x, int32_t scale, RoundingMode mode = RoundingMode::HalfEven) const
+    {
+        if (x.mantissa_ == 0)
+        {
+            throw std::domain_error("BigDecimal: division by zero");
+        }
+        // q = mantissa * 10^shift / x.mantissa has the requested scale
+        int64_t shift = int64_t(scale) - scale_ + x.scale_;
+        BigInteger n = mantissa_, d = x.mantissa_;
+        if (shift >= 0)
+        {
+            n.multiplyPow10(static_cast<size_t>(shift));
+        }
+        else
+        {
+            d.multiplyPow10(static_cast<size_t>(-shift));
+        }
+        BigInteger q = n / d;
+        BigInteger r = n - q * d;
+        bool negative = mantissa_.getSign() != x.mantissa_.getSign() && mantissa_ != 0;
+        int half = -1;
+        if (r != 0)
+        {
+            BigInteger twice = r.abs() * 2;
+            BigInteger d_abs = d.abs();
+            half = (twice == d_abs) ? 0 : ((twice > d_abs) ? 1 : -1);
+        }
+        if (roundsAway(mode, negative, half, r != 0, q.lastDigit() % 2 != 0))
+        {
+            roundAway(q, negative);
+        }
+        return BigDecimal(q, scale);
+    }
+
+    friend BigDecimal operator+(const BigDecimal &x, const BigDecimal &y)
+    {
+        BigDecimal cpy = x;
+        cpy += y;
+        return cpy;
+    }
+
+    friend BigDecimal operator-(const BigDecimal &x, const BigDecimal &y)
+    {
+        BigDecimal cpy = x;
+        cpy -= y;
+        return cpy;
+    }
+
+    friend BigDecimal operator*(const BigDecimal &x, const BigDecimal &y)
+    {
+        BigDecimal cpy = x;
+        cpy *= y;
+        return cpy;
+    }
+
+    friend BigDecimal operator/(const BigDecimal &x, const BigDecimal &y)
+    {
+        BigDecimal cpy = x;
+        cpy /= y;
+        return cpy;
+    }
+
+    // numeric comparison, 1.0 and 1.00 are equal
+    int compare(const BigDecimal &x) const
+    {
+        if (mantissa_.getSign() != x.mantissa_.getSign())
+        {
+            return mantissa_.getSign() ? 1 : -1;
+        }
+        if (scale_ == x.scale_)
+        {
+            return (mantissa_ == x.mantissa_) ? 0 : ((mantissa_ > x.mantissa_) ? 1 : -1);
+        }
+        BigDecimal lhs = *this, rhs = x;
+        alignScales(lhs, rhs);
+        return (lhs.mantissa_ == rhs.mantissa_) ? 0 : ((lhs.mantissa_ > rhs.mantissa_) ? 1 : -1);
+    }
+
+    bool operator==(const BigDecimal &x) const
+    {
+        return compare(x) == 0;
+    }
+
+    bool operator!=(const BigDecimal &x) const
+    {
+        return compare(x) != 0;
+    }
+
+    bool operator<(const BigDecimal &x) const
+    {
+        return compare(x) < 0;
+    }
+
+    bool operator>(const BigDecimal &x) const
+    {
+        return compare(x) > 0;
+    }
+
+    bool operator<=(const BigDecimal &x) const
+    {
+        return compare(x) <= 0;
+    }
+
+    bool operator>=(const BigDecimal &x) const
+    {
+        return compare(x) >= 0;
+    }
+
+    Rational toRational() const
+    {
+        BigInteger n = mantissa_, d = 1;
+        if (scale_ >= 0)
+        {
+            d.multiplyPow10(static_cast<size_t>(scale_));
+        }
+        else
+        {
+            n.multiplyPow10(static_cast<size_t>(-int64_t(scale_)));
+        }
+        return Rational(n, d);
+    }
+
+    // Plain notation with exactly max(scale, 0) digits after the point
+    std::string toString() const
+    {
+        const BigIntegerDigits &digits = mantissa_.getDigits();
+        std::string res;
+        size_t frac = scale_ > 0 ? static_cast<size_t>(scale_) : 0;
+        size_t zeros = scale_ < 0 && mantissa_ != 0 ? static_cast<size_t>(-int64_t(scale_)) : 0;
+        size_t int_digits = digits.size() > frac ? digits.size() - frac : 1;
+        res.reserve(int_digits + frac + zeros + 2);
+        if (!mantissa_.getSign())
+        {
+            res.push_back('-');
+        }
+        for (size_t i = int_digits + frac; i > frac; --i)
+        {
+            res.push_back(i - 1 < digits.size() ? '0' + digits[i - 1] : '0');
+        }
+        res.append(zeros, '0');
+        if (frac != 0)
+        {
+            res.push_back('.');
+            for (size_t i = frac; i > 0; --i)
+            {
+                res.push_back(i - 1 < digits.size() ? '0' + digits[i - 1] : '0');
+            }
+        }
+        return res;
+    }
+
+    // Scientific notation d[.ddd]E(+|-)n keeping every mantissa digit, so the result parses
+    // back to the same mantissa and scale; zero prints as 0E(+|-)n with n = -scale
+    std::string toScientificString() const
+    {
+        const BigIntegerDigits &digits = mantissa_.getDigits();
+        int64_t exponent = static_cast<int64_t>(digits.size()) - 1 - scale_;
+        std::string res;
+        res.reserve(digits.size() + 16);
+        if (!mantissa_.getSign())
+        {
+            res.push_back('-');
+        }
+        res.push_back('0' + digits.back());
+        if (digits.size() > 1)
+        {
+            res.push_back('.');
+            for (size_t i = digits.size() - 1; i > 0; --i)
+            {
+                res.push_back('0' + digits[i - 1]);
+            }
+        }
+        res.push_back('E');
+        res.push_back(exponent < 0 ? '-' : '+');
+        res += std::to_string(exponent < 0 ? -exponent : exponent);
+        return res;
+    }
+
+    friend std::ostream &operator<<(std::ostream &out, const BigDecimal &x)
+    {
+        out << x.toString();
+        return out;
+    }
+
+    friend std::istream &operator>>(std::istream &in, BigDecimal &x)
+    {
+        std::string s;
+        in >> s;
+        x = BigDecimal(s);
+        return in;
+    }
+};
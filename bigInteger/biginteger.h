@@ -1,1028 +1,3177 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <memory>
+#include <initializer_list>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#ifdef __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+
+// Operation kinds tracked by BigIntegerStats
+enum class BigIntegerOp
+{
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Increment,
+    Decrement,
+    Gcd,
+    RationalAdd,
+    RationalSub,
+    RationalMul,
+    RationalDiv,
+    RationalNormalize,
+    Count
+};
 
-bool operator>(std::vector<uint16_t> a, std::vector<uint16_t> b);
-
-class BigInteger
+// Per-thread counters, filled only when compiled with BIGINTEGER_STATS,
+// otherwise every snapshot stays zero
+struct BigIntegerStats
 {
-private:
-    std::vector<uint16_t> number;
-    bool sign = 1;
+    static constexpr size_t kOps = static_cast<size_t>(BigIntegerOp::Count);
+    static constexpr size_t kBuckets = 32; // bucket i: largest operand has [2^i, 2^(i+1)) digits
+
+    uint64_t ops[kOps] = {};
+    uint64_t sizeHistogram[kOps][kBuckets] = {};
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t allocatedBytes = 0;
+    std::chrono::nanoseconds normalizeTime{0}; // includes the gcd() calls made by normalize()
+    std::chrono::nanoseconds gcdTime{0};
 
-    void flatten(std::vector<uint16_t> &x)
+    static BigIntegerStats snapshot()
     {
-        uint16_t next = 0;
-        for (size_t i = 0; i < x.size(); ++i)
+        return local();
+    }
+
+    static void reset()
+    {
+        local() = BigIntegerStats();
+    }
+
+    static const char *opName(BigIntegerOp op)
+    {
+        static const char *names[kOps] = {"add", "sub", "mul", "div", "mod", "increment", "decrement", "gcd",
+                                          "rational_add", "rational_sub", "rational_mul", "rational_div",
+                                          "rational_normalize"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    static BigIntegerStats &local()
+    {
+        thread_local BigIntegerStats stats;
+        return stats;
+    }
+
+    static void recordOp(BigIntegerOp op, size_t digits)
+    {
+        size_t bucket = 0;
+        while (digits > 1 && bucket + 1 < kBuckets)
         {
-            x[i] = next + x[i];
-            next = x[i] / 10;
-            x[i] %= 10;
+            digits >>= 1;
+            ++bucket;
         }
-        while (next != 0)
+        BigIntegerStats &stats = local();
+        ++stats.ops[static_cast<size_t>(op)];
+        ++stats.sizeHistogram[static_cast<size_t>(op)][bucket];
+    }
+
+    class Timer
+    {
+    private:
+        std::chrono::nanoseconds BigIntegerStats::*field_;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        explicit Timer(std::chrono::nanoseconds BigIntegerStats::*field)
+            : field_(field), start_(std::chrono::steady_clock::now())
         {
-            x.push_back(next % 10);
-            next /= 10;
         }
-        for (size_t i = x.size(); i > 0; --i)
+
+        ~Timer()
         {
-            if (x[i - 1] == 0)
-            {
-                x.pop_back();
-            }
-            else
-            {
-                break;
-            }
+            local().*field_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_);
         }
+    };
+};
+
+// Allocator for digit storage that counts allocations into BigIntegerStats
+template <typename T>
+struct BigIntegerAllocator
+{
+    using value_type = T;
+
+    BigIntegerAllocator() = default;
+
+    template <typename U>
+    BigIntegerAllocator(const BigIntegerAllocator<U> &)
+    {
     }
 
-public:
-    BigInteger() = default;
+    T *allocate(size_t n)
+    {
+        BigIntegerStats &stats = BigIntegerStats::local();
+        ++stats.allocations;
+        stats.allocatedBytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
 
-    BigInteger(int64_t num)
+    void deallocate(T *p, size_t n)
+    {
+        ++BigIntegerStats::local().deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const BigIntegerAllocator &, const BigIntegerAllocator &)
+    {
+        return true;
+    }
+
+    friend bool operator!=(const BigIntegerAllocator &, const BigIntegerAllocator &)
+    {
+        return false;
+    }
+};
+
+// Copy-on-write digit storage, enabled with BIGINTEGER_COW. Copies share one reference-counted
+// vector, so copying a value (abs(), unary minus, temporaries in Rational and gcd callers) is
+// O(1); the first mutating access through a shared handle clones the digits. Reads go
+// through the const overloads and never clone. The interface is the subset of std::vector
+// that BigInteger uses.
+template <typename Vector>
+class CowDigits
+{
+private:
+    std::shared_ptr<Vector> buffer_;
+
+    Vector &mutableBuffer()
     {
-        if (num < 0)
+        if (!buffer_)
         {
-            sign = 0;
-            num = -num;
-            while (num != 0)
-            {
-                number.push_back(num % 10);
-                num /= 10;
-            }
+            buffer_ = std::make_shared<Vector>();
         }
-        else if (num == 0)
+        else if (buffer_.use_count() > 1)
         {
-            sign = 1;
-            number.push_back(0);
+            buffer_ = std::make_shared<Vector>(*buffer_);
+        }
+        return *buffer_;
+    }
+
+public:
+    using value_type = typename Vector::value_type;
+    using iterator = value_type *;
+    using const_iterator = const value_type *;
+
+    CowDigits() = default;
+
+    CowDigits(size_t n, value_type value) : buffer_(std::make_shared<Vector>(n, value))
+    {
+    }
+
+    CowDigits(std::initializer_list<value_type> values) : buffer_(std::make_shared<Vector>(values))
+    {
+    }
+
+    template <typename It, typename = decltype(*std::declval<It>())>
+    CowDigits(It first, It last) : buffer_(std::make_shared<Vector>(first, last))
+    {
+    }
+
+    // number of handles sharing the digits, 0 for an empty handle
+    long useCount() const
+    {
+        return buffer_.use_count();
+    }
+
+    size_t size() const
+    {
+        return buffer_ ? buffer_->size() : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const value_type *data() const
+    {
+        return buffer_ ? buffer_->data() : nullptr;
+    }
+
+    value_type *data()
+    {
+        return mutableBuffer().data();
+    }
+
+    const value_type &operator[](size_t i) const
+    {
+        return (*buffer_)[i];
+    }
+
+    value_type &operator[](size_t i)
+    {
+        return mutableBuffer()[i];
+    }
+
+    const value_type &back() const
+    {
+        return buffer_->back();
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + size();
+    }
+
+    void push_back(value_type x)
+    {
+        mutableBuffer().push_back(x);
+    }
+
+    void pop_back()
+    {
+        mutableBuffer().pop_back();
+    }
+
+    void resize(size_t n)
+    {
+        mutableBuffer().resize(n);
+    }
+
+    void reserve(size_t n)
+    {
+        mutableBuffer().reserve(n);
+    }
+
+    void assign(size_t n, value_type value)
+    {
+        if (buffer_ && buffer_.use_count() == 1)
+        {
+            buffer_->assign(n, value);
         }
         else
         {
-            sign = 1;
-            while (num != 0)
-            {
-                number.push_back(num % 10);
-                num /= 10;
-            }
+            buffer_ = std::make_shared<Vector>(n, value);
         }
     }
 
-    BigInteger(std::string s)
+    template <typename It, typename = decltype(*std::declval<It>())>
+    void assign(It first, It last)
     {
-        if (s[0] == '-')
+        if (buffer_ && buffer_.use_count() == 1)
         {
-            sign = 0;
-            number.resize(s.size() - 1);
-            for (size_t i = 0; i < number.size(); ++i)
-            {
-                number[i] = s[s.size() - i - 1] - '0';
-            }
+            buffer_->assign(first, last);
         }
         else
         {
-            sign = 1;
-            number.resize(s.size());
-            for (size_t i = 0; i < number.size(); ++i)
-            {
-                number[i] = s[s.size() - i - 1] - '0';
-            }
+            buffer_ = std::make_shared<Vector>(first, last);
         }
     }
 
-    BigInteger(bool _sign, std::vector<uint16_t> _number)
+    // a shared buffer is dropped instead of being cloned and cleared
+    void clear()
     {
-        sign = _sign;
-        for (size_t i = 0; i < _number.size(); ++i)
+        if (buffer_ && buffer_.use_count() == 1)
+        {
+            buffer_->clear();
+        }
+        else
         {
-            number.push_back(_number[i]);
+            buffer_.reset();
         }
     }
 
-    size_t getSize()
+    iterator insert(const_iterator pos, size_t n, value_type value)
     {
-        return number.size();
+        size_t offset = pos - data();
+        Vector &v = mutableBuffer();
+        v.insert(v.begin() + offset, n, value);
+        return v.data() + offset;
     }
 
-    BigInteger &operator=(BigInteger x)
+    iterator erase(const_iterator first, const_iterator last)
     {
-        swap(x);
-        return *this;
+        size_t from = first - data(), to = last - data();
+        Vector &v = mutableBuffer();
+        v.erase(v.begin() + from, v.begin() + to);
+        return v.data() + from;
     }
 
-    void swap(BigInteger &x)
+    friend bool operator==(const CowDigits &a, const CowDigits &b)
     {
-        std::swap(sign, x.sign);
-        std::swap(number, x.number);
+        return a.buffer_ == b.buffer_ || std::equal(a.begin(), a.end(), b.begin(), b.end());
     }
 
-    bool getSign() const
+    friend bool operator!=(const CowDigits &a, const CowDigits &b)
     {
-        return sign;
+        return !(a == b);
     }
+};
 
-    BigInteger operator-()
-    {
-        if (number.size() == 1 && number[0] == 0)
-        {
-            return BigInteger(sign, number);
-        }
-        return BigInteger(!sign, number);
-    }
+#ifdef BIGINTEGER_STATS
+using BigIntegerDigitVector = std::vector<uint16_t, BigIntegerAllocator<uint16_t>>;
+#define BIGINTEGER_STATS_OP(op, digits) BigIntegerStats::recordOp(BigIntegerOp::op, digits)
+#define BIGINTEGER_STATS_TIMER(field) BigIntegerStats::Timer bigIntegerStatsTimer(&BigIntegerStats::field)
+#else
+using BigIntegerDigitVector = std::vector<uint16_t>;
+#define BIGINTEGER_STATS_OP(op, digits)
+#define BIGINTEGER_STATS_TIMER(field)
+#endif
 
-    bool operator>(const BigInteger &x) const
+#ifdef BIGINTEGER_COW
+using BigIntegerDigits = CowDigits<BigIntegerDigitVector>;
+#else
+using BigIntegerDigits = BigIntegerDigitVector;
+#endif
+
+bool operator>(const BigIntegerDigits &a, const BigIntegerDigits &b);
+
+class BigInteger
+{
+private:
+    BigIntegerDigits number;
+    bool sign = 1;
+
+    // Carries the column sums of a schoolbook product into number. The columns are 32-bit
+    // because 16 bits overflow once both operands are longer than ~800 digits
+    void flatten(const std::vector<uint32_t> &x)
     {
-        if (sign > x.sign)
+        number.resize(x.size());
+        uint64_t next = 0;
+        for (size_t i = 0; i < x.size(); ++i)
         {
-            return true;
+            next += x[i];
+            number[i] = next % 10;
+            next /= 10;
         }
-        else if (sign < x.sign)
+        while (next != 0)
         {
-            return false;
+            number.push_back(next % 10);
+            next /= 10;
         }
-        else
+        for (size_t i = number.size(); i > 0; --i)
         {
-            if (number.size() > x.number.size())
-            {
-                return (sign);
-            }
-            else if (number.size() < x.number.size())
+            if (number[i - 1] == 0)
             {
-                return !(sign);
+                number.pop_back();
             }
             else
             {
-                for (size_t i = number.size(); i > 0; --i)
-                {
-                    if (number[i - 1] > x.number[i - 1])
-                    {
-                        return (sign);
-                    }
-                    else if (number[i - 1] < x.number[i - 1])
-                    {
-                        return !(sign);
-                    }
-                }
-                return false;
+                break;
             }
         }
     }
 
-    bool operator<(const BigInteger &x) const
+    // Single-word kernels used by the int64_t overloads, they never build a temporary BigInteger
+    static uint64_t magnitude(int64_t x)
     {
-        return x > *this;
+        return (x < 0) ? 0 - static_cast<uint64_t>(x) : static_cast<uint64_t>(x);
     }
 
-    bool operator==(const BigInteger &x) const
+    void assignMagnitude(uint64_t m)
     {
-        if (sign != x.sign || number.size() != x.number.size())
+        number.clear();
+        do
         {
-            return false;
-        }
-        else
+            number.push_back(m % 10);
+            m /= 10;
+        } while (m != 0);
+    }
+
+    // |*this| as a word, only meaningful when compareMagnitude() says it fits
+    uint64_t toMagnitude() const
+    {
+        uint64_t m = 0;
+        for (size_t i = number.size(); i > 0; --i)
         {
-            for (size_t i = number.size(); i > 0; --i)
-            {
-                if (number[i - 1] != x.number[i - 1])
-                {
-                    return false;
-                }
-            }
-            return true;
+            m = m * 10 + number[i - 1];
         }
+        return m;
     }
 
-    bool operator>=(const BigInteger &x) const
+    static uint64_t mixHash(uint64_t h)
     {
-        return (*this > x || *this == x);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
     }
 
-    bool operator<=(const BigInteger &x) const
+    // Folds four digits per 64-bit word, the length and sign seed the state so that
+    // the short tail needs no separate marker
+    static size_t hashDigits(const uint16_t *digits, size_t len, bool positive)
     {
-        return (*this < x || *this == x);
+        uint64_t h = mixHash(len * 2 + positive);
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            uint64_t word;
+            std::memcpy(&word, digits + i, sizeof(word));
+            h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+        }
+        if (i < len)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, digits + i, (len - i) * sizeof(uint16_t));
+            h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+        }
+        return static_cast<size_t>(mixHash(h));
     }
 
-    bool operator!=(const BigInteger &x) const
+    // Same hash as BigInteger(x).hash() without building the digit vector
+    static size_t hashWord(int64_t x)
     {
-        return !(*this == x);
+        uint16_t digits[20];
+        size_t len = 0;
+        uint64_t m = magnitude(x);
+        do
+        {
+            digits[len++] = m % 10;
+            m /= 10;
+        } while (m != 0);
+        return hashDigits(digits, len, x >= 0);
     }
 
-    void removeLeadingZeros()
+    int compareMagnitude(uint64_t m) const
     {
-        for (size_t i = number.size(); i > 0; --i)
+        uint16_t digits[20];
+        size_t len = 0;
+        do
         {
-            if (number[i - 1] == 0)
+            digits[len++] = m % 10;
+            m /= 10;
+        } while (m != 0);
+        if (number.empty())
+        {
+            return (len == 1 && digits[0] == 0) ? 0 : -1;
+        }
+        if (number.size() != len)
+        {
+            return (number.size() > len) ? 1 : -1;
+        }
+        for (size_t i = len; i > 0; --i)
+        {
+            if (number[i - 1] != digits[i - 1])
             {
-                number.pop_back();
+                return (number[i - 1] > digits[i - 1]) ? 1 : -1;
             }
-            else
+        }
+        return 0;
+    }
+
+    void addMagnitude(uint64_t m)
+    {
+        for (size_t i = 0; m != 0; ++i)
+        {
+            if (i == number.size())
             {
-                break;
+                number.push_back(0);
             }
+            uint64_t cur = number[i] + m % 10;
+            number[i] = cur % 10;
+            m = m / 10 + cur / 10;
         }
-        if (number.empty())
+    }
+
+    // requires |*this| >= m
+    void subtractMagnitude(uint64_t m)
+    {
+        uint16_t borrow = 0;
+        for (size_t i = 0; m != 0 || borrow != 0; ++i)
         {
-            number.push_back(0);
-            sign = 1;
+            uint16_t sub = m % 10 + borrow;
+            m /= 10;
+            if (number[i] < sub)
+            {
+                number[i] = number[i] + 10 - sub;
+                borrow = 1;
+            }
+            else
+            {
+                number[i] -= sub;
+                borrow = 0;
+            }
         }
+        removeLeadingZeros();
     }
 
-    BigInteger &operator+=(const BigInteger &x)
+    void addSigned(bool y_sign, uint64_t m)
     {
-        uint16_t tmp = 0;
-        uint16_t next = 0;
-        if (sign == x.sign)
-        { // числа имеют один и тот же знак, складываем "в столбик"
-            for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
+        if (m == 0)
+        {
+            return;
+        }
+        if (sign == y_sign)
+        {
+            addMagnitude(m);
+        }
+        else if (compareMagnitude(m) >= 0)
+        {
+            subtractMagnitude(m);
+        }
+        else
+        {
+            assignMagnitude(m - toMagnitude());
+            sign = y_sign;
+        }
+    }
+
+    static void checkDivisor(bool zero)
+    {
+        if (zero)
+        {
+            throw std::domain_error("BigInteger: division by zero");
+        }
+    }
+
+    // multiplySmall/divideSmall/remainderSmall require 0 < m <= kSmallLimit so that no step
+    // overflows or divides by zero; the public operators check the divisor first
+    static constexpr uint64_t kSmallLimit = UINT64_MAX / 10;
+
+    void multiplySmall(uint64_t m)
+    {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < number.size(); ++i)
+        {
+            uint64_t cur = number[i] * m + carry;
+            number[i] = cur % 10;
+            carry = cur / 10;
+        }
+        while (carry != 0)
+        {
+            number.push_back(carry % 10);
+            carry /= 10;
+        }
+        removeLeadingZeros();
+    }
+
+    uint64_t divideSmall(uint64_t m)
+    {
+        uint64_t rem = 0;
+        for (size_t i = number.size(); i > 0; --i)
+        {
+            rem = rem * 10 + number[i - 1];
+            number[i - 1] = rem / m;
+            rem %= m;
+        }
+        removeLeadingZeros();
+        return rem;
+    }
+
+    uint64_t remainderSmall(uint64_t m) const
+    {
+        uint64_t rem = 0;
+        for (size_t i = number.size(); i > 0; --i)
+        {
+            rem = (rem * 10 + number[i - 1]) % m;
+        }
+        return rem;
+    }
+
+    // Radix conversion works on base 10^9 limbs and moves a whole word of target digits
+    // (base^k <= 2^32) per short division or multiply-add step
+    static constexpr uint32_t kLimbBase = 1000000000;
+
+    std::vector<uint32_t> toLimbs() const
+    {
+        std::vector<uint32_t> limbs((number.size() + 8) / 9, 0);
+        for (size_t i = number.size(); i > 0; --i)
+        {
+            limbs[(i - 1) / 9] = limbs[(i - 1) / 9] * 10 + number[i - 1];
+        }
+        return limbs;
+    }
+
+    void assignLimbs(const std::vector<uint32_t> &limbs)
+    {
+        number.clear();
+        for (uint32_t limb : limbs)
+        {
+            for (size_t j = 0; j < 9; ++j)
             {
-                if (i < x.number.size())
-                {
-                    tmp += x.number[i];
-                }
-                if (i < number.size())
-                {
-                    tmp += number[i];
-                }
-                if (i >= number.size())
-                { // выходим за макс.число разрядов
-                    number.push_back((next + tmp) % 10);
-                }
-                else
+                number.push_back(limb % 10);
+                limb /= 10;
+            }
+        }
+        removeLeadingZeros();
+    }
+
+    // Long products regroup the decimal digits into base 10^9 limbs (a linear repacking,
+    // no radix conversion) and multiply those with Karatsuba above kKaratsubaLimbs
+    static constexpr size_t kLimbMultiplyDigits = 32;
+    static constexpr size_t kKaratsubaLimbs = 32;
+
+    // res[0, n + m) += a * b, schoolbook on limbs with one carry chain per row
+    static void multiplyLimbsBasecase(const uint32_t *a, size_t n, const uint32_t *b, size_t m, uint32_t *res)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint64_t carry = 0, digit = a[i];
+            if (digit == 0)
+            {
+                continue;
+            }
+            for (size_t j = 0; j < m; ++j)
+            {
+                uint64_t cur = res[i + j] + digit * b[j] + carry;
+                res[i + j] = static_cast<uint32_t>(cur % kLimbBase);
+                carry = cur / kLimbBase;
+            }
+            for (size_t k = i + m; carry != 0; ++k)
+            {
+                uint64_t cur = res[k] + carry;
+                res[k] = static_cast<uint32_t>(cur % kLimbBase);
+                carry = cur / kLimbBase;
+            }
+        }
+    }
+
+    // res[0, n) += x[0, len), res must be long enough to absorb the carry
+    static void addLimbs(uint32_t *res, const uint32_t *x, size_t len)
+    {
+        uint32_t carry = 0;
+        size_t i = 0;
+        for (; i < len; ++i)
+        {
+            uint32_t cur = res[i] + x[i] + carry;
+            carry = cur >= kLimbBase;
+            res[i] = carry ? cur - kLimbBase : cur;
+        }
+        for (; carry != 0; ++i)
+        {
+            uint32_t cur = res[i] + carry;
+            carry = cur >= kLimbBase;
+            res[i] = carry ? cur - kLimbBase : cur;
+        }
+    }
+
+    // res -= x where res >= x
+    static void subtractLimbs(std::vector<uint32_t> &res, const std::vector<uint32_t> &x)
+    {
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < res.size() && (i < x.size() || borrow != 0); ++i)
+        {
+            uint32_t sub = (i < x.size() ? x[i] : 0) + borrow;
+            borrow = res[i] < sub;
+            res[i] = borrow ? res[i] + kLimbBase - sub : res[i] - sub;
+        }
+    }
+
+    // res[0, 2n) += a * b for two n-limb operands
+    static void karatsuba(const uint32_t *a, const uint32_t *b, size_t n, uint32_t *res)
+    {
+        if (n <= kKaratsubaLimbs)
+        {
+            multiplyLimbsBasecase(a, n, b, n, res);
+            return;
+        }
+        size_t h = n / 2, hi = n - h;
+        // (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 is the middle term
+        std::vector<uint32_t> sa(hi + 1, 0), sb(hi + 1, 0);
+        std::copy(a + h, a + n, sa.begin());
+        std::copy(b + h, b + n, sb.begin());
+        addLimbs(sa.data(), a, h);
+        addLimbs(sb.data(), b, h);
+        std::vector<uint32_t> low(2 * h, 0), high(2 * hi, 0), mid(2 * hi + 2, 0);
+        karatsuba(a, b, h, low.data());
+        karatsuba(a + h, b + h, hi, high.data());
+        karatsuba(sa.data(), sb.data(), hi + 1, mid.data());
+        subtractLimbs(mid, low);
+        subtractLimbs(mid, high);
+        while (!mid.empty() && mid.back() == 0)
+        {
+            mid.pop_back();
+        }
+        addLimbs(res, low.data(), low.size());
+        addLimbs(res + h, mid.data(), mid.size());
+        addLimbs(res + 2 * h, high.data(), high.size());
+    }
+
+    // |a| * |b| for operands in limb form, the longer one is cut into pieces of the shorter's length
+    static std::vector<uint32_t> multiplyLimbs(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+    {
+        const std::vector<uint32_t> &small = a.size() <= b.size() ? a : b;
+        const std::vector<uint32_t> &large = a.size() <= b.size() ? b : a;
+        size_t n = small.size();
+        std::vector<uint32_t> res(a.size() + b.size() + 1, 0);
+        if (n <= kKaratsubaLimbs)
+        {
+            multiplyLimbsBasecase(large.data(), large.size(), small.data(), n, res.data());
+            return res;
+        }
+        std::vector<uint32_t> piece(n), part(2 * n);
+        for (size_t pos = 0; pos < large.size(); pos += n)
+        {
+            size_t len = std::min(n, large.size() - pos);
+            std::fill(piece.begin(), piece.end(), 0);
+            std::copy(large.begin() + pos, large.begin() + pos + len, piece.begin());
+            std::fill(part.begin(), part.end(), 0);
+            karatsuba(piece.data(), small.data(), n, part.data());
+            size_t used = std::min(part.size(), res.size() - 1 - pos);
+            addLimbs(res.data() + pos, part.data(), used);
+        }
+        return res;
+    }
+
+    // largest k with base^k <= 2^32
+    static size_t chunkDigits(unsigned base, uint64_t &chunk)
+    {
+        size_t k = 0;
+        chunk = 1;
+        while (chunk * base <= (uint64_t(1) << 32))
+        {
+            chunk *= base;
+            ++k;
+        }
+        return k;
+    }
+
+    static int digitValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'z')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'Z')
+        {
+            return c - 'A' + 10;
+        }
+        return 36;
+    }
+
+    friend class Rational;
+
+public:
+    BigInteger() = default;
+
+    BigInteger(int64_t num)
+    {
+        sign = (num >= 0);
+        assignMagnitude(magnitude(num));
+    }
+
+    BigInteger(std::string s)
+    {
+        if (s[0] == '-')
+        {
+            sign = 0;
+            number.resize(s.size() - 1);
+            for (size_t i = 0; i < number.size(); ++i)
+            {
+                number[i] = s[s.size() - i - 1] - '0';
+            }
+        }
+        else
+        {
+            sign = 1;
+            number.resize(s.size());
+            for (size_t i = 0; i < number.size(); ++i)
+            {
+                number[i] = s[s.size() - i - 1] - '0';
+            }
+        }
+    }
+
+    BigInteger(bool _sign, const BigIntegerDigits &_number) : number(_number), sign(_sign)
+    {
+    }
+
+    size_t getSize() const
+    {
+        return number.size();
+    }
+
+    // decimal digits of |*this|, least significant first
+    const BigIntegerDigits &getDigits() const
+    {
+        return number;
+    }
+
+    BigInteger &operator=(BigInteger x)
+    {
+        swap(x);
+        return *this;
+    }
+
+    void swap(BigInteger &x)
+    {
+        std::swap(sign, x.sign);
+        std::swap(number, x.number);
+    }
+
+    bool getSign() const
+    {
+        return sign;
+    }
+
+    BigInteger operator-() const
+    {
+        if (number.size() == 1 && number[0] == 0)
+        {
+            return BigInteger(sign, number);
+        }
+        return BigInteger(!sign, number);
+    }
+
+    // Three-way comparison of magnitudes, no copies of either operand
+    static int compareDigits(const BigIntegerDigits &a, const BigIntegerDigits &b)
+    {
+        if (a.size() != b.size())
+        {
+            return (a.size() > b.size()) ? 1 : -1;
+        }
+        for (size_t i = a.size(); i > 0; --i)
+        {
+            if (a[i - 1] != b[i - 1])
+            {
+                return (a[i - 1] > b[i - 1]) ? 1 : -1;
+            }
+        }
+        return 0;
+    }
+
+    int compare(const BigInteger &x) const
+    {
+        if (sign != x.sign)
+        {
+            return sign ? 1 : -1;
+        }
+        int res = compareDigits(number, x.number);
+        return sign ? res : -res;
+    }
+
+    bool operator>(const BigInteger &x) const
+    {
+        return compare(x) > 0;
+    }
+
+    bool operator<(const BigInteger &x) const
+    {
+        return compare(x) < 0;
+    }
+
+    bool operator==(const BigInteger &x) const
+    {
+        if (sign != x.sign || number.size() != x.number.size())
+        {
+            return false;
+        }
+        else
+        {
+            for (size_t i = number.size(); i > 0; --i)
+            {
+                if (number[i - 1] != x.number[i - 1])
                 {
-                    number[i] = (next + tmp) % 10;
+                    return false;
                 }
-                next = (next + tmp) / 10;
-                tmp = 0;
             }
-            if (next != 0)
+            return true;
+        }
+    }
+
+    bool operator>=(const BigInteger &x) const
+    {
+        return compare(x) >= 0;
+    }
+
+    bool operator<=(const BigInteger &x) const
+    {
+        return compare(x) <= 0;
+    }
+
+    bool operator!=(const BigInteger &x) const
+    {
+        return !(*this == x);
+    }
+
+    int compare(int64_t y) const
+    {
+        bool y_sign = (y >= 0);
+        if (sign != y_sign)
+        {
+            return sign ? 1 : -1;
+        }
+        int res = compareMagnitude(magnitude(y));
+        return sign ? res : -res;
+    }
+
+    bool operator==(int64_t y) const
+    {
+        return compare(y) == 0;
+    }
+
+    bool operator!=(int64_t y) const
+    {
+        return compare(y) != 0;
+    }
+
+    bool operator<(int64_t y) const
+    {
+        return compare(y) < 0;
+    }
+
+    bool operator>(int64_t y) const
+    {
+        return compare(y) > 0;
+    }
+
+    bool operator<=(int64_t y) const
+    {
+        return compare(y) <= 0;
+    }
+
+    bool operator>=(int64_t y) const
+    {
+        return compare(y) >= 0;
+    }
+
+#ifdef __cpp_impl_three_way_comparison
+    std::strong_ordering operator<=>(const BigInteger &x) const
+    {
+        return compare(x) <=> 0;
+    }
+
+    std::strong_ordering operator<=>(int64_t y) const
+    {
+        return compare(y) <=> 0;
+    }
+#endif
+
+    // Hash of the value: equal values hash equally whatever their storage
+    size_t hash() const
+    {
+        if (number.empty())
+        {
+            return hashWord(0);
+        }
+        return hashDigits(number.data(), number.size(), sign);
+    }
+
+    void removeLeadingZeros()
+    {
+        for (size_t i = number.size(); i > 0; --i)
+        {
+            if (number[i - 1] == 0)
+            {
+                number.pop_back();
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (number.empty())
+        {
+            number.push_back(0);
+            sign = 1;
+        }
+    }
+
+private:
+    // Bodies of += and -=, also used inside division so that stats only see the caller's operation
+    void add(const BigInteger &x)
+    {
+        uint16_t tmp = 0;
+        uint16_t next = 0;
+        if (sign == x.sign)
+        { // числа имеют один и тот же знак, складываем "в столбик"
+            for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
+            {
+                if (i < x.number.size())
+                {
+                    tmp += x.number[i];
+                }
+                if (i < number.size())
+                {
+                    tmp += number[i];
+                }
+                if (i >= number.size())
+                { // выходим за макс.число разрядов
+                    number.push_back((next + tmp) % 10);
+                }
+                else
+                {
+                    number[i] = (next + tmp) % 10;
+                }
+                next = (next + tmp) / 10;
+                tmp = 0;
+            }
+            if (next != 0)
+            {
+                number.push_back(next); // проверяем, не вышли ли ещё раз за макс.число разрядов
+            }
+        }
+        else
+        {
+            if (x.number > number)
+            { // числа имеют разный знак, выясняем какое больше и делаем вычитание "в столбик"
+                sign = x.sign;
+                for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
+                {
+                    if (i < number.size())
+                    {
+                        if (tmp + number[i] > x.number[i])
+                        { // занимаем "1" (или нет) в след.разряде и вычитаем
+                            number[i] = x.number[i] + 10 - number[i] - tmp;
+                            tmp = 1;
+                        }
+                        else
+                        {
+                            number[i] = x.number[i] - number[i] - tmp;
+                            tmp = 0;
+                        }
+                    }
+                    else
+                    { // если в меньшем числе кончились разряды
+                        if (tmp != 0)
+                        {
+                            if (x.number[i] < tmp)
+                            {
+                                number.push_back(x.number[i] + 10 - tmp);
+                            }
+                            else
+                            {
+                                number.push_back(x.number[i] - tmp);
+                                tmp = 0;
+                            }
+                        }
+                        else
+                        {
+                            number.push_back(x.number[i]);
+                        }
+                    }
+                }
+            }
+            else
+            { // всё то же самое, только сделано зеркально, если x меньше
+                for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
+                {
+                    if (i < x.number.size())
+                    {
+                        if (number[i] < x.number[i] + tmp)
+                        {
+                            number[i] = number[i] + 10 - x.number[i] - tmp;
+                            tmp = 1;
+                        }
+                        else
+                        {
+                            number[i] -= x.number[i] + tmp;
+                            tmp = 0;
+                        }
+                    }
+                    else
+                    {
+                        if (tmp != 0)
+                        {
+                            if (number[i] < tmp)
+                            {
+                                number[i] += 10 - tmp;
+                            }
+                            else
+                            {
+                                number[i] -= tmp;
+                                tmp = 0;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        removeLeadingZeros(); // удаление лидирующих нулей
+    }
+
+    void subtract(const BigInteger &x)
+    {
+        if (number.size() != 1 || number[0] != 0)
+        {
+            sign = !sign;
+        }
+        add(x);
+        if (number.size() != 1 || number[0] != 0)
+        {
+            sign = !sign;
+        }
+    }
+
+public:
+    BigInteger &operator+=(const BigInteger &x)
+    {
+        BIGINTEGER_STATS_OP(Add, std::max(number.size(), x.number.size()));
+        add(x);
+        return *this;
+    }
+
+    BigInteger &operator-=(const BigInteger &x)
+    {
+        BIGINTEGER_STATS_OP(Sub, std::max(number.size(), x.number.size()));
+        subtract(x);
+        return *this;
+    }
+
+    BigInteger &operator++()
+    {
+        BIGINTEGER_STATS_OP(Increment, number.size());
+        addSigned(true, 1);
+        return *this;
+    }
+
+    BigInteger operator++(int)
+    {
+        BigInteger cpy = *this;
+        ++(*this);
+        return cpy;
+    }
+
+    BigInteger &operator--()
+    {
+        BIGINTEGER_STATS_OP(Decrement, number.size());
+        addSigned(false, 1);
+        return *this;
+    }
+
+    BigInteger operator--(int)
+    {
+        BigInteger cpy = *this;
+        --(*this);
+        return cpy;
+    }
+
+    BigInteger &operator*=(const BigInteger &x)
+    {
+        BIGINTEGER_STATS_OP(Mul, std::max(number.size(), x.number.size()));
+        if (std::min(number.size(), x.number.size()) >= kLimbMultiplyDigits)
+        {
+            assignLimbs(multiplyLimbs(toLimbs(), x.toLimbs()));
+            sign = (sign == x.sign) || (number.size() == 1 && number[0] == 0);
+            return *this;
+        }
+        std::vector<uint32_t> tmp(number.size() + x.number.size() - 1, 0);
+        for (size_t i = 0; i < x.number.size(); ++i)
+        {
+            uint32_t digit = x.number[i];
+            for (size_t j = 0; j < number.size(); ++j)
+            {
+                tmp[i + j] += digit * number[j];
+            }
+        }
+        flatten(tmp);
+        sign = (sign == x.sign);
+        if (number.empty())
+        {
+            number.push_back(0);
+            sign = 1;
+        }
+
+        return *this;
+    }
+
+    void pushFrontFrac(const uint16_t x)
+    {
+        if (number.empty())
+        {
+            number.push_back(x);
+            return;
+        }
+        number.push_back(0);
+        for (size_t i = number.size(); i > 1; --i)
+        {
+            number[i - 1] = number[i - 2];
+        }
+        number[0] = x;
+    }
+
+    void pushFront(const uint16_t x)
+    {
+        if (number.size() == 1 && number[0] == 0)
+        {
+            number[0] = x;
+            return;
+        }
+        number.push_back(0);
+        for (size_t i = number.size(); i > 1; --i)
+        {
+            number[i - 1] = number[i - 2];
+        }
+        number[0] = x;
+    }
+
+    // *this *= 10^k, a digit shift in the decimal representation
+    void multiplyPow10(size_t k)
+    {
+        if (k == 0 || *this == 0)
+        {
+            return;
+        }
+        number.insert(number.begin(), k, 0);
+    }
+
+    // *this /= 10^k, truncating toward zero like operator/=
+    void dividePow10(size_t k)
+    {
+        if (k >= number.size())
+        {
+            *this = BigInteger(0);
+            return;
+        }
+        number.erase(number.begin(), number.begin() + k);
+        removeLeadingZeros();
+    }
+
+    // Truncating division; dividing by zero throws std::domain_error, as do % and the
+    // int64 overloads below
+    BigInteger &operator/=(const BigInteger &y)
+    {
+        checkDivisor(!y);
+        BIGINTEGER_STATS_OP(Div, std::max(number.size(), y.number.size()));
+        if (number.size() < y.number.size())
+        {
+            *this = BigInteger(0);
+            return *this;
+        }
+        if (y == 2)
+        {
+            number[0] /= 2;
+            if (number.size() > 1)
+            {
+                for (size_t i = 1; i < number.size() - 1; ++i)
+                {
+                    if (number[i] % 2 == 1)
+                    {
+                        number[i - 1] += 5;
+                    }
+                    number[i] /= 2;
+                }
+                if (number[number.size() - 1] % 2 == 1)
+                {
+                    number[number.size() - 2] += 5;
+                }
+                number[number.size() - 1] /= 2;
+            }
+            // -1 / 2 must come out as 0, not -0
+            removeLeadingZeros();
+            return *this;
+        }
+        BigInteger q(0), rem(0), div(1, y.number);
+        bool flag_first = 0, flag_second = 0;
+        std::vector<BigInteger> divs(11);
+        divs[0] = BigInteger(0);
+        for (size_t i = 1; i < 11; ++i)
+        {
+            divs[i] = divs[i - 1];
+            divs[i].add(div);
+        }
+        size_t pos = number.size();
+        while (true)
+        {
+            flag_second = 0;
+            while (pos > 0 && div.number > rem.number)
+            {
+                rem.pushFront(number[pos - 1]);
+                --pos;
+                if (flag_first && flag_second)
+                {
+                    q.pushFront(0);
+                }
+                flag_second = 1;
+            }
+            flag_first = 1;
+            if (pos == 0 && rem < div)
+            {
+                if (flag_second)
+                {
+                    q.pushFront(0);
+                }
+                break;
+            }
+            else
+            {
+                size_t l = 0, r = 10;
+                while (r - l > 1)
+                {
+                    if (divs[(r + l) / 2].number > rem.number)
+                    {
+                        r = (r + l) / 2;
+                    }
+                    else
+                    {
+                        l = (r + l) / 2;
+                    }
+                }
+                rem.subtract(divs[l]);
+                q.pushFront(l);
+            }
+        }
+        sign = (sign == y.sign);
+        number = q.number;
+        removeLeadingZeros();
+
+        return *this;
+    }
+
+    BigInteger &operator%=(const BigInteger &y)
+    {
+        checkDivisor(!y);
+        BIGINTEGER_STATS_OP(Mod, std::max(number.size(), y.number.size()));
+        if (number.size() < y.number.size())
+        {
+            return *this;
+        }
+        BigInteger q(0), rem(0), div(1, y.number);
+        bool flag_first = 0, flag_second = 0;
+        std::vector<BigInteger> divs(11);
+        divs[0] = BigInteger(0);
+        for (size_t i = 1; i < 11; ++i)
+        {
+            divs[i] = divs[i - 1];
+            divs[i].add(div);
+        }
+        size_t pos = number.size();
+        while (true)
+        {
+            flag_second = 0;
+            while (pos > 0 && div.number > rem.number)
+            {
+                rem.pushFront(number[pos - 1]);
+                --pos;
+                if (flag_first && flag_second)
+                {
+                    q.pushFront(0);
+                }
+                flag_second = 1;
+            }
+            flag_first = 1;
+            if (pos == 0 && rem < div)
+            {
+                if (flag_second)
+                {
+                    q.pushFront(0);
+                }
+                break;
+            }
+            else
+            {
+                size_t l = 0, r = 10;
+                while (r - l > 1)
+                {
+                    if (divs[(r + l) / 2].number > rem.number)
+                    {
+                        r = (r + l) / 2;
+                    }
+                    else
+                    {
+                        l = (r + l) / 2;
+                    }
+                }
+                rem.subtract(divs[l]);
+                q.pushFront(l);
+            }
+        }
+        number = rem.number;
+        removeLeadingZeros();
+
+        return *this;
+    }
+
+    BigInteger &operator+=(int64_t y)
+    {
+        BIGINTEGER_STATS_OP(Add, number.size());
+        addSigned(y >= 0, magnitude(y));
+        return *this;
+    }
+
+    BigInteger &operator-=(int64_t y)
+    {
+        BIGINTEGER_STATS_OP(Sub, number.size());
+        addSigned(y <= 0, magnitude(y));
+        return *this;
+    }
+
+    BigInteger &operator*=(int64_t y)
+    {
+        uint64_t m = magnitude(y);
+        if (m > kSmallLimit)
+        {
+            return *this *= BigInteger(y);
+        }
+        BIGINTEGER_STATS_OP(Mul, number.size());
+        sign = (sign == (y >= 0));
+        multiplySmall(m);
+        return *this;
+    }
+
+    BigInteger &operator/=(int64_t y)
+    {
+        checkDivisor(y == 0);
+        uint64_t m = magnitude(y);
+        if (m > kSmallLimit)
+        {
+            return *this /= BigInteger(y);
+        }
+        BIGINTEGER_STATS_OP(Div, number.size());
+        sign = (sign == (y >= 0));
+        divideSmall(m);
+        return *this;
+    }
+
+    BigInteger &operator%=(int64_t y)
+    {
+        checkDivisor(y == 0);
+        uint64_t m = magnitude(y);
+        if (m > kSmallLimit)
+        {
+            return *this %= BigInteger(y);
+        }
+        BIGINTEGER_STATS_OP(Mod, number.size());
+        uint64_t rem = remainderSmall(m);
+        assignMagnitude(rem);
+        if (rem == 0)
+        {
+            sign = 1;
+        }
+        return *this;
+    }
+
+    explicit operator bool() const
+    {
+        return !(number.size() == 1 && number[0] == 0);
+    }
+
+    std::string toString(unsigned base = 10) const
+    {
+        std::string s;
+        if (base == 10)
+        {
+            s.reserve(number.size() + 1);
+            if (!sign)
+            {
+                s.push_back('-');
+            }
+            for (size_t i = number.size(); i > 0; --i)
+            {
+                s.push_back('0' + number[i - 1]);
+            }
+
+            return s;
+        }
+        if (base < 2 || base > 36)
+        {
+            throw std::invalid_argument("BigInteger::toString: base must be in [2, 36]");
+        }
+        const char *alphabet = "0123456789abcdefghijklmnopqrstuvwxyz";
+        uint64_t chunk;
+        size_t k = chunkDigits(base, chunk);
+        std::vector<uint32_t> limbs = toLimbs();
+        while (!limbs.empty() && limbs.back() == 0)
+        {
+            limbs.pop_back();
+        }
+        // digits come out least significant first
+        while (!limbs.empty())
+        {
+            uint64_t rem = 0;
+            for (size_t i = limbs.size(); i > 0; --i)
+            {
+                uint64_t cur = rem * kLimbBase + limbs[i - 1];
+                limbs[i - 1] = cur / chunk;
+                rem = cur % chunk;
+            }
+            while (!limbs.empty() && limbs.back() == 0)
+            {
+                limbs.pop_back();
+            }
+            for (size_t j = 0; j < k && (rem != 0 || !limbs.empty()); ++j)
+            {
+                s.push_back(alphabet[rem % base]);
+                rem /= base;
+            }
+        }
+        if (s.empty())
+        {
+            s.push_back('0');
+        }
+        if (!sign)
+        {
+            s.push_back('-');
+        }
+        std::reverse(s.begin(), s.end());
+
+        return s;
+    }
+
+    // Parses an optional sign followed by digits 0-9a-z (any case) in the given base
+    static BigInteger fromString(const std::string &s, unsigned base = 10)
+    {
+        if (base < 2 || base > 36)
+        {
+            throw std::invalid_argument("BigInteger::fromString: base must be in [2, 36]");
+        }
+        size_t pos = 0;
+        bool negative = false;
+        if (pos < s.size() && (s[pos] == '-' || s[pos] == '+'))
+        {
+            negative = (s[pos] == '-');
+            ++pos;
+        }
+        if (pos == s.size())
+        {
+            throw std::invalid_argument("BigInteger::fromString: no digits");
+        }
+        for (size_t i = pos; i < s.size(); ++i)
+        {
+            if (digitValue(s[i]) >= static_cast<int>(base))
+            {
+                throw std::invalid_argument("BigInteger::fromString: invalid digit");
+            }
+        }
+        BigInteger res;
+        if (base == 10)
+        {
+            res.number.resize(s.size() - pos);
+            for (size_t i = 0; i < res.number.size(); ++i)
+            {
+                res.number[i] = s[s.size() - i - 1] - '0';
+            }
+        }
+        else
+        {
+            uint64_t chunk;
+            size_t k = chunkDigits(base, chunk);
+            std::vector<uint32_t> limbs;
+            // first chunk is short so that the rest are exactly k digits
+            size_t len = (s.size() - pos) % k;
+            if (len == 0)
+            {
+                len = k;
+            }
+            while (pos < s.size())
+            {
+                uint64_t carry = 0, scale = 1;
+                for (size_t j = 0; j < len; ++j)
+                {
+                    carry = carry * base + digitValue(s[pos + j]);
+                    scale *= base;
+                }
+                pos += len;
+                len = k;
+                for (size_t i = 0; i < limbs.size(); ++i)
+                {
+                    uint64_t cur = limbs[i] * scale + carry;
+                    limbs[i] = cur % kLimbBase;
+                    carry = cur / kLimbBase;
+                }
+                while (carry != 0)
+                {
+                    limbs.push_back(carry % kLimbBase);
+                    carry /= kLimbBase;
+                }
+            }
+            res.assignLimbs(limbs);
+        }
+        res.sign = !negative;
+        res.removeLeadingZeros();
+        return res;
+    }
+
+    // Writes straight from the digits in fixed-size chunks, padding falls back to toString()
+    friend std::ostream &operator<<(std::ostream &out, const BigInteger &x)
+    {
+        if (out.width() != 0)
+        {
+            out << x.toString();
+            return out;
+        }
+        char buffer[4096];
+        size_t len = 0;
+        if (!x.sign)
+        {
+            buffer[len++] = '-';
+        }
+        for (size_t i = x.number.size(); i > 0; --i)
+        {
+            buffer[len++] = '0' + x.number[i - 1];
+            if (len == sizeof(buffer))
+            {
+                out.write(buffer, len);
+                len = 0;
+            }
+        }
+        out.write(buffer, len);
+
+        return out;
+    }
+
+    // Parses digits directly from the stream buffer into the digit vector
+    friend std::istream &operator>>(std::istream &in, BigInteger &x)
+    {
+        std::istream::sentry guard(in);
+        if (!guard)
+        {
+            return in;
+        }
+        std::streambuf *buf = in.rdbuf();
+        x.number.clear();
+        x.sign = 1;
+        int c = buf->sgetc();
+        if (c == '-' || c == '+')
+        {
+            x.sign = (c == '+');
+            c = buf->snextc();
+        }
+        while (c != std::char_traits<char>::eof() && c >= '0' && c <= '9')
+        {
+            x.number.push_back(c - '0');
+            c = buf->snextc();
+        }
+        if (c == std::char_traits<char>::eof())
+        {
+            in.setstate(std::ios_base::eofbit);
+        }
+        if (x.number.empty())
+        {
+            in.setstate(std::ios_base::failbit);
+        }
+        std::reverse(x.number.begin(), x.number.end());
+        x.removeLeadingZeros();
+
+        return in;
+    }
+
+    friend BigInteger operator+(const BigInteger &x, const BigInteger &y)
+    {
+        BigInteger cpy = x;
+        cpy += y;
+        return cpy;
+    }
+
+    friend BigInteger operator-(const BigInteger &x, const BigInteger &y)
+    {
+        BigInteger cpy = x;
+        cpy -= y;
+        return cpy;
+    }
+
+    friend BigInteger operator%(const BigInteger &x, const BigInteger &y)
+    {
+        BigInteger cpy = x;
+        cpy %= y;
+        return cpy;
+    }
+
+    friend BigInteger operator*(const BigInteger &x, const BigInteger &y)
+    {
+        BigInteger cpy = x;
+        cpy *= y;
+        return cpy;
+    }
+
+    friend BigInteger operator/(const BigInteger &x, const BigInteger &y)
+    {
+        BigInteger cpy = x;
+        cpy /= y;
+        return cpy;
+    }
+
+    friend BigInteger operator+(const BigInteger &x, int64_t y)
+    {
+        BigInteger cpy = x;
+        cpy += y;
+        return cpy;
+    }
+
+    friend BigInteger operator+(int64_t x, const BigInteger &y)
+    {
+        BigInteger cpy = y;
+        cpy += x;
+        return cpy;
+    }
+
+    friend BigInteger operator-(const BigInteger &x, int64_t y)
+    {
+        BigInteger cpy = x;
+        cpy -= y;
+        return cpy;
+    }
+
+    friend BigInteger operator-(int64_t x, const BigInteger &y)
+    {
+        BigInteger cpy = -y;
+        cpy += x;
+        return cpy;
+    }
+
+    friend BigInteger operator*(const BigInteger &x, int64_t y)
+    {
+        BigInteger cpy = x;
+        cpy *= y;
+        return cpy;
+    }
+
+    friend BigInteger operator*(int64_t x, const BigInteger &y)
+    {
+        BigInteger cpy = y;
+        cpy *= x;
+        return cpy;
+    }
+
+    friend BigInteger operator/(const BigInteger &x, int64_t y)
+    {
+        BigInteger cpy = x;
+        cpy /= y;
+        return cpy;
+    }
+
+    friend BigInteger operator/(int64_t x, const BigInteger &y)
+    {
+        checkDivisor(!y);
+        uint64_t m = magnitude(x);
+        if (y.compareMagnitude(m) > 0)
+        {
+            return BigInteger(0);
+        }
+        BigInteger res;
+        res.assignMagnitude(m / y.toMagnitude());
+        res.sign = ((x >= 0) == y.sign);
+        res.removeLeadingZeros();
+        return res;
+    }
+
+    friend BigInteger operator%(const BigInteger &x, int64_t y)
+    {
+        BigInteger cpy = x;
+        cpy %= y;
+        return cpy;
+    }
+
+    friend BigInteger operator%(int64_t x, const BigInteger &y)
+    {
+        checkDivisor(!y);
+        uint64_t m = magnitude(x);
+        if (y.compareMagnitude(m) > 0)
+        {
+            return BigInteger(x);
+        }
+        BigInteger res;
+        res.assignMagnitude(m % y.toMagnitude());
+        res.sign = (x >= 0);
+        res.removeLeadingZeros();
+        return res;
+    }
+
+    friend bool operator==(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) == 0;
+    }
+
+    friend bool operator!=(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) != 0;
+    }
+
+    friend bool operator<(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) > 0;
+    }
+
+    friend bool operator>(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) < 0;
+    }
+
+    friend bool operator<=(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) >= 0;
+    }
+
+    friend bool operator>=(int64_t x, const BigInteger &y)
+    {
+        return y.compare(x) <= 0;
+    }
+
+    uint16_t lastDigit() const
+    {
+        return number[0];
+    }
+
+    BigInteger abs() const
+    {
+        return BigInteger(1, number);
+    }
+
+    // Sums many values without carrying on every addition: each column keeps a plain sum of
+    // digits and carries are resolved only when the headroom runs out or in finish().
+    // Partial accumulators (e.g. one per thread) are combined with merge().
+    class Accumulator
+    {
+    private:
+        std::vector<uint32_t> positive_, negative_;
+        uint32_t load_ = 0; // every column is at most 9 * load_
+
+        static constexpr uint32_t kMaxLoad = UINT32_MAX / 9;
+
+        static void carry(std::vector<uint32_t> &columns)
+        {
+            uint64_t next = 0;
+            for (size_t i = 0; i < columns.size(); ++i)
+            {
+                next += columns[i];
+                columns[i] = next % 10;
+                next /= 10;
+            }
+            while (next != 0)
+            {
+                columns.push_back(next % 10);
+                next /= 10;
+            }
+        }
+
+        template <typename Digits>
+        static void addColumns(std::vector<uint32_t> &columns, const Digits &x)
+        {
+            if (columns.size() < x.size())
+            {
+                columns.resize(x.size(), 0);
+            }
+            for (size_t i = 0; i < x.size(); ++i)
+            {
+                columns[i] += x[i];
+            }
+        }
+
+        static BigInteger toBigInteger(std::vector<uint32_t> columns)
+        {
+            carry(columns);
+            BigInteger res;
+            res.number.assign(columns.begin(), columns.end());
+            res.removeLeadingZeros();
+            return res;
+        }
+
+        void normalize()
+        {
+            carry(positive_);
+            carry(negative_);
+            load_ = 1;
+        }
+
+    public:
+        Accumulator &operator+=(const BigInteger &x)
+        {
+            BIGINTEGER_STATS_OP(Add, x.number.size());
+            if (load_ == kMaxLoad)
+            {
+                normalize();
+            }
+            addColumns(x.sign ? positive_ : negative_, x.number);
+            ++load_;
+            return *this;
+        }
+
+        Accumulator &operator-=(const BigInteger &x)
+        {
+            BIGINTEGER_STATS_OP(Sub, x.number.size());
+            if (load_ == kMaxLoad)
+            {
+                normalize();
+            }
+            addColumns(x.sign ? negative_ : positive_, x.number);
+            ++load_;
+            return *this;
+        }
+
+        Accumulator &merge(const Accumulator &x)
+        {
+            if (load_ > kMaxLoad - x.load_)
+            {
+                normalize();
+            }
+            if (load_ > kMaxLoad - x.load_)
+            {
+                Accumulator cpy = x;
+                cpy.normalize();
+                return merge(cpy);
+            }
+            addColumns(positive_, x.positive_);
+            addColumns(negative_, x.negative_);
+            load_ += x.load_;
+            return *this;
+        }
+
+        BigInteger finish() const
+        {
+            BigInteger res = toBigInteger(positive_);
+            res.subtract(toBigInteger(negative_));
+            return res;
+        }
+    };
+};
+
+bool operator>(const BigIntegerDigits &a, const BigIntegerDigits &b)
+{
+    return BigInteger::compareDigits(a, b) > 0;
+}
+
+BigInteger binaryGcd(BigInteger &a, BigInteger &b)
+{
+    if (a == 0)
+        return b;
+    if (b == 0)
+        return a;
+    if (a == b)
+        return a;
+    if (a == 1 || b == 1)
+        return 1;
+    if (a.lastDigit() % 2 == 0 && b.lastDigit() % 2 == 0)
+    {
+        a /= 2;
+        b /= 2;
+        return 2 * binaryGcd(a, b);
+    }
+    if (a.lastDigit() % 2 == 0 && b.lastDigit() % 2 != 0)
+    {
+        a /= 2;
+        return binaryGcd(a, b);
+    }
+
+    if (a.lastDigit() % 2 != 0 && b.lastDigit() % 2 == 0)
+    {
+        b /= 2;
+        return binaryGcd(a, b);
+    }
+
+    if (a < b)
+    {
+        b -= a;
+        b /= 2;
+        return binaryGcd(b, a);
+    }
+
+    else
+    {
+        a -= b;
+        a /= 2;
+        return binaryGcd(a, b);
+    }
+}
+
+BigInteger gcd(BigInteger &a, BigInteger &b)
+{
+    BIGINTEGER_STATS_OP(Gcd, std::max(a.getSize(), b.getSize()));
+    BIGINTEGER_STATS_TIMER(gcdTime);
+    return binaryGcd(a, b);
+}
+
+class Rational
+{
+private:
+    BigInteger num, den;
+    bool reduced = true; // false while a lazily computed value still waits for normalize()
+    // Values whose reduced num and den fit in int64_t live in snum / sden (sden > 0, snum is
+    // never INT64_MIN) and num / den are left empty. Word-sized results never allocate;
+    // an overflowing operation promotes both operands to BigInteger and continues there.
+    int64_t snum = 0, sden = 1;
+    bool is_small = true;
+
+    static bool addOverflow(int64_t a, int64_t b, int64_t &res)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_add_overflow(a, b, &res) || res == std::numeric_limits<int64_t>::min();
+#else
+        if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+            (b < 0 && a <= std::numeric_limits<int64_t>::min() - b))
+        {
+            return true;
+        }
+        res = a + b;
+        return false;
+#endif
+    }
+
+    static bool mulOverflow(int64_t a, int64_t b, int64_t &res)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_mul_overflow(a, b, &res) || res == std::numeric_limits<int64_t>::min();
+#else
+        if (a != 0 && b != 0)
+        {
+            uint64_t ma = BigInteger::magnitude(a), mb = BigInteger::magnitude(b);
+            if (ma > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) / mb)
+            {
+                return true;
+            }
+        }
+        res = a * b;
+        return false;
+#endif
+    }
+
+    // binary gcd on machine words
+    static uint64_t gcdSmall(uint64_t a, uint64_t b)
+    {
+        if (a == 0 || b == 0)
+        {
+            return a | b;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        int shift = __builtin_ctzll(a | b);
+        a >>= __builtin_ctzll(a);
+        while (b != 0)
+        {
+            b >>= __builtin_ctzll(b);
+            if (a > b)
+            {
+                std::swap(a, b);
+            }
+            b -= a;
+        }
+#else
+        int shift = 0;
+        while (((a | b) & 1) == 0)
+        {
+            a >>= 1;
+            b >>= 1;
+            ++shift;
+        }
+        while ((a & 1) == 0)
+        {
+            a >>= 1;
+        }
+        while (b != 0)
+        {
+            while ((b & 1) == 0)
+            {
+                b >>= 1;
+            }
+            if (a > b)
+            {
+                std::swap(a, b);
+            }
+            b -= a;
+        }
+#endif
+        return a << shift;
+    }
+
+    void promote()
+    {
+        if (is_small)
+        {
+            num = snum;
+            den = sden;
+            is_small = false;
+            reduced = true;
+        }
+    }
+
+    // returns to the word-sized form when a reduced value fits again
+    void shrink()
+    {
+        if (is_small || !reduced || num.getSize() > 18 || den.getSize() > 18)
+        {
+            return;
+        }
+        snum = static_cast<int64_t>(num.toMagnitude());
+        if (!num.getSign())
+        {
+            snum = -snum;
+        }
+        sden = static_cast<int64_t>(den.toMagnitude());
+        num = BigInteger();
+        den = BigInteger();
+        is_small = true;
+    }
+
+    // x itself when it is already a BigInteger value, otherwise its promoted copy in storage
+    static const Rational &promoted(const Rational &x, Rational &storage)
+    {
+        if (!x.is_small)
+        {
+            return x;
+        }
+        storage = x;
+        storage.promote();
+        return storage;
+    }
+
+    size_t digitCount() const
+    {
+        if (!is_small)
+        {
+            return std::max(num.getSize(), den.getSize());
+        }
+        uint64_t m = std::max(BigInteger::magnitude(snum), static_cast<uint64_t>(sden));
+        size_t digits = 1;
+        while (m >= 10)
+        {
+            m /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+    // the word-sized operations return false on overflow and leave *this untouched
+    bool addSmall(int64_t c, int64_t d)
+    {
+        int64_t g = static_cast<int64_t>(gcdSmall(sden, d));
+        int64_t lhs, rhs, t, res_den;
+        if (mulOverflow(snum, d / g, lhs) || mulOverflow(c, sden / g, rhs) || addOverflow(lhs, rhs, t))
+        {
+            return false;
+        }
+        if (t == 0)
+        {
+            snum = 0;
+            sden = 1;
+            return true;
+        }
+        int64_t g2 = static_cast<int64_t>(gcdSmall(BigInteger::magnitude(t), g));
+        if (mulOverflow(sden / g, d / g2, res_den))
+        {
+            return false;
+        }
+        snum = t / g2;
+        sden = res_den;
+        return true;
+    }
+
+    bool multiplySmall(int64_t c, int64_t d)
+    {
+        if (snum == 0 || c == 0)
+        {
+            snum = 0;
+            sden = 1;
+            return true;
+        }
+        int64_t g1 = static_cast<int64_t>(gcdSmall(BigInteger::magnitude(snum), d));
+        int64_t g2 = static_cast<int64_t>(gcdSmall(BigInteger::magnitude(c), sden));
+        int64_t res_num, res_den;
+        if (mulOverflow(snum / g1, c / g2, res_num) || mulOverflow(sden / g2, d / g1, res_den))
+        {
+            return false;
+        }
+        snum = res_num;
+        sden = res_den;
+        return true;
+    }
+
+    void negate()
+    {
+        if (is_small)
+        {
+            snum = -snum;
+        }
+        else
+        {
+            num = -num;
+        }
+    }
+
+    // Number of digits (of num or den) up to which results are left unreduced, 0 keeps every
+    // result reduced. The setting is per thread.
+    static size_t &lazyThreshold()
+    {
+        thread_local size_t threshold = 0;
+        return threshold;
+    }
+
+    // keeps den positive, which is all that comparisons and printing need from an unreduced value
+    void fixSign()
+    {
+        if (!den.getSign())
+        {
+            num = -num;
+            den = -den;
+        }
+    }
+
+    // Correctly rounded (round-half-even) conversion to a binary floating point type:
+    // one scaled division leaves digits + 2 or 3 significant bits plus a sticky bit
+    template <typename T>
+    T toFloatingPoint() const
+    {
+        static_assert(std::numeric_limits<T>::radix == 2, "binary floating point expected");
+        const int digits = std::numeric_limits<T>::digits;
+        const int64_t min_exp = std::numeric_limits<T>::min_exponent - 1; // exponent of the smallest normal
+        if (is_small)
+        {
+            // both operands convert exactly, so the one division rounds correctly
+            const uint64_t exact = uint64_t(1) << digits;
+            if (BigInteger::magnitude(snum) <= exact && static_cast<uint64_t>(sden) <= exact)
+            {
+                return static_cast<T>(snum) / static_cast<T>(sden);
+            }
+            Rational cpy = *this;
+            cpy.promote();
+            return cpy.toFloatingPoint<T>();
+        }
+        if (num == 0)
+        {
+            return T(0);
+        }
+        bool negative = !num.getSign();
+        BigInteger a = num.abs();
+        // the value lies in (10^(e - 1), 10^(e + 1)), far out of range needs no division
+        int64_t e10 = static_cast<int64_t>(a.getSize()) - static_cast<int64_t>(den.getSize());
+        if (e10 - 1 > std::numeric_limits<T>::max_exponent10 + 1)
+        {
+            return negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+        }
+        if (e10 + 1 < std::numeric_limits<T>::min_exponent10 - std::numeric_limits<T>::digits10 - 3)
+        {
+            return negative ? -T(0) : T(0);
+        }
+        // q = floor(a * 2^shift / den) gets digits + 2 or digits + 3 bits
+        double log2_value = (leadingLog10(a) - leadingLog10(den)) * 3.321928094887362;
+        int64_t shift = digits + 2 - static_cast<int64_t>(std::floor(log2_value));
+        BigInteger scaled = a, divisor = den;
+        if (shift >= 0)
+        {
+            scaled *= powerOfTwo(shift);
+        }
+        else
+        {
+            divisor *= powerOfTwo(-shift);
+        }
+        BigInteger q = scaled / divisor;
+        bool sticky = (q * divisor != scaled);
+        uint64_t mantissa = q.toMagnitude();
+        int64_t bits = 0;
+        while (bits < 64 && (mantissa >> bits) != 0)
+        {
+            ++bits;
+        }
+        // subnormal results keep fewer bits
+        int64_t exponent = bits - 1 - shift;
+        int64_t precision = digits;
+        if (exponent < min_exp)
+        {
+            precision -= min_exp - exponent;
+        }
+        int64_t drop = bits - precision;
+        if (drop >= 64)
+        {
+            return negative ? -T(0) : T(0);
+        }
+        uint64_t rest = mantissa & ((uint64_t(1) << drop) - 1);
+        uint64_t half = uint64_t(1) << (drop - 1);
+        mantissa >>= drop;
+        if (rest > half || (rest == half && (sticky || (mantissa & 1))))
+        {
+            ++mantissa;
+        }
+        T res = std::ldexp(static_cast<T>(mantissa), static_cast<int>(drop - shift));
+        return negative ? -res : res;
+    }
+
+    // log10 of |x| from its leading 17 digits
+    static double leadingLog10(const BigInteger &x)
+    {
+        const BigIntegerDigits &digits = x.getDigits();
+        size_t take = std::min<size_t>(digits.size(), 17);
+        double lead = 0;
+        for (size_t i = 0; i < take; ++i)
+        {
+            lead = lead * 10 + digits[digits.size() - 1 - i];
+        }
+        return std::log10(lead) + static_cast<double>(digits.size() - take);
+    }
+
+    static BigInteger powerOfTwo(int64_t k)
+    {
+        BigInteger res = 1, base = 2;
+        while (k != 0)
+        {
+            if (k & 1)
+            {
+                res *= base;
+            }
+            k >>= 1;
+            if (k != 0)
+            {
+                base *= base;
+            }
+        }
+        return res;
+    }
+
+    void reduce()
+    {
+        size_t threshold = lazyThreshold();
+        if (threshold != 0 && std::max(num.getSize(), den.getSize()) <= threshold)
+        {
+            fixSign();
+            reduced = false;
+            return;
+        }
+        normalize();
+    }
+
+    // Henrici's addition of reduced fractions: only gcd(b, d) and gcd(t, gcd(b, d)) are taken,
+    // so the products stay smaller and the result is already reduced. Requires d > 0
+    void addReduced(const BigInteger &c, const BigInteger &d)
+    {
+        if (c == 0)
+        {
+            return;
+        }
+        if (num == 0)
+        {
+            num = c;
+            den = d;
+            return;
+        }
+        BigInteger b_copy = den, d_copy = d;
+        BigInteger d1 = gcd(b_copy, d_copy);
+        if (d1 == 1)
+        {
+            num *= d;
+            num += c * den;
+            den *= d;
+            return;
+        }
+        BigInteger b_part = den / d1;
+        num *= d / d1;
+        num += c * b_part;
+        if (num == 0)
+        {
+            den = 1;
+            return;
+        }
+        BigInteger t_copy = num.abs();
+        BigInteger d2 = gcd(t_copy, d1);
+        if (d2 == 1)
+        {
+            den = b_part * d;
+        }
+        else
+        {
+            num /= d2;
+            den = b_part * (d / d2);
+        }
+    }
+
+    // multiplication of reduced fractions cancelling the cross gcds first. Requires d > 0
+    void multiplyReduced(const BigInteger &c, const BigInteger &d)
+    {
+        if (num == 0)
+        {
+            return;
+        }
+        if (c == 0)
+        {
+            num = 0;
+            den = 1;
+            return;
+        }
+        BigInteger a_abs = num.abs(), d_copy = d, c_abs = c.abs(), b_copy = den;
+        BigInteger g1 = gcd(a_abs, d_copy), g2 = gcd(c_abs, b_copy);
+        if (g1 != 1)
+        {
+            num /= g1;
+        }
+        if (g2 != 1)
+        {
+            num *= c / g2;
+            den /= g2;
+        }
+        else
+        {
+            num *= c;
+        }
+        if (g1 != 1)
+        {
+            den *= d / g1;
+        }
+        else
+        {
+            den *= d;
+        }
+    }
+
+    bool canUseReducedAlgorithms(const Rational &x) const
+    {
+        return reduced && x.reduced && lazyThreshold() == 0;
+    }
+
+public:
+    Rational() = default;
+
+    Rational(int64_t a, int64_t b = 1)
+    {
+        if (b != 0 && a != std::numeric_limits<int64_t>::min() && b != std::numeric_limits<int64_t>::min())
+        {
+            int64_t g = static_cast<int64_t>(gcdSmall(BigInteger::magnitude(a), BigInteger::magnitude(b)));
+            snum = (b < 0) ? -a / g : a / g;
+            sden = (b < 0) ? -b / g : b / g;
+            return;
+        }
+        is_small = false;
+        num = BigInteger(a);
+        den = BigInteger(b);
+        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
+        BigInteger tmp = gcd(tmp_num, tmp_den);
+        num /= tmp;
+        den /= tmp;
+        if (num.getSign() == den.getSign())
+        {
+            if (num.getSign() == 0)
             {
-                number.push_back(next); // проверяем, не вышли ли ещё раз за макс.число разрядов
+                num = -num;
+                den = -den;
             }
         }
         else
         {
-            if (x.number > number)
-            { // числа имеют разный знак, выясняем какое больше и делаем вычитание "в столбик"
-                sign = x.sign;
-                for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
-                {
-                    if (i < number.size())
-                    {
-                        if (tmp + number[i] > x.number[i])
-                        { // занимаем "1" (или нет) в след.разряде и вычитаем
-                            number[i] = x.number[i] + 10 - number[i] - tmp;
-                            tmp = 1;
-                        }
-                        else
-                        {
-                            number[i] = x.number[i] - number[i] - tmp;
-                            tmp = 0;
-                        }
-                    }
-                    else
-                    { // если в меньшем числе кончились разряды
-                        if (tmp != 0)
-                        {
-                            if (x.number[i] < tmp)
-                            {
-                                number.push_back(x.number[i] + 10 - tmp);
-                            }
-                            else
-                            {
-                                number.push_back(x.number[i] - tmp);
-                                tmp = 0;
-                            }
-                        }
-                        else
-                        {
-                            number.push_back(x.number[i]);
-                        }
-                    }
-                }
-            }
-            else
-            { // всё то же самое, только сделано зеркально, если x меньше
-                for (size_t i = 0; i < std::max(number.size(), x.number.size()); ++i)
-                {
-                    if (i < x.number.size())
-                    {
-                        if (number[i] < x.number[i] + tmp)
-                        {
-                            number[i] = number[i] + 10 - x.number[i] - tmp;
-                            tmp = 1;
-                        }
-                        else
-                        {
-                            number[i] -= x.number[i] + tmp;
-                            tmp = 0;
-                        }
-                    }
-                    else
-                    {
-                        if (tmp != 0)
-                        {
-                            if (number[i] < tmp)
-                            {
-                                number[i] += 10 - tmp;
-                            }
-                            else
-                            {
-                                number[i] -= tmp;
-                                tmp = 0;
-                            }
-                        }
-                    }
-                }
+            if (num.getSign() == 1)
+            {
+                num = -num;
+                den = -den;
             }
         }
-        removeLeadingZeros(); // удаление лидирующих нулей
-
-        return *this;
     }
 
-    BigInteger &operator-=(const BigInteger &x) {
-        if (number.size() != 1 || number[0] != 0)
+    // Exact value of a finite float or double: mantissa / 2^k or mantissa * 2^k
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    explicit Rational(T x)
+    {
+        static_assert(std::numeric_limits<T>::digits <= 62, "mantissa must fit in int64_t");
+        if (!std::isfinite(x))
         {
-            sign = !sign;
+            throw std::invalid_argument("Rational: value is not finite");
         }
-        *this += x;
-        if (number.size() != 1 || number[0] != 0)
+        int exponent;
+        T fraction = std::frexp(x, &exponent);
+        int64_t mantissa = static_cast<int64_t>(std::ldexp(fraction, std::numeric_limits<T>::digits));
+        exponent -= std::numeric_limits<T>::digits;
+        if (mantissa == 0)
         {
-            sign = !sign;
+            exponent = 0;
         }
-        return *this;
+        // an odd mantissa over a power of two is already reduced
+        while (exponent < 0 && mantissa % 2 == 0)
+        {
+            mantissa /= 2;
+            ++exponent;
+        }
+        is_small = false;
+        num = mantissa;
+        den = 1;
+        if (exponent > 0)
+        {
+            num *= powerOfTwo(exponent);
+        }
+        else if (exponent < 0)
+        {
+            den = powerOfTwo(-exponent);
+        }
+        shrink();
     }
 
-    BigInteger &operator++()
+    Rational(BigInteger a, BigInteger b = 1)
     {
-        uint16_t next = 0;
-        if (sign)
+        is_small = false;
+        num = a, den = b;
+        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
+        BigInteger tmp = gcd(tmp_num, tmp_den);
+        num /= tmp;
+        den /= tmp;
+        if (num.getSign() == den.getSign())
         {
-            for (size_t i = 0; i < number.size(); ++i)
-            {
-                ++number[i];
-                next = number[i] / 10;
-                number[i] %= 10;
-                if (next == 0)
-                {
-                    break;
-                }
-            }
-            if (next != 0)
+            if (num.getSign() == 0)
             {
-                number.push_back(1);
+                num = -num;
+                den = -den;
             }
         }
         else
         {
-            for (size_t i = 0; i < number.size(); ++i)
+            if (num.getSign() == 1)
             {
-                if (number[i] > 0)
-                {
-                    --number[i];
-                    break;
-                }
-                else
-                {
-                    number[i] += 9;
-                    --number[i + 1];
-                }
+                num = -num;
+                den = -den;
             }
         }
-        removeLeadingZeros();
-
-        return *this;
+        shrink();
     }
 
-    BigInteger operator++(int)
+    Rational &operator=(Rational x)
     {
-        BigInteger cpy = *this;
-        ++(*this);
-        return cpy;
+        swap(x);
+        return *this;
     }
 
-    BigInteger &operator--()
+    void normalize()
     {
-        uint16_t next = 0;
-        if (sign)
+        if (is_small)
         {
-            for (size_t i = 0; i < number.size(); ++i)
+            return;
+        }
+        BIGINTEGER_STATS_OP(RationalNormalize, std::max(num.getSize(), den.getSize()));
+        BIGINTEGER_STATS_TIMER(normalizeTime);
+        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
+        BigInteger tmp = gcd(tmp_num, tmp_den);
+        num /= tmp;
+        den /= tmp;
+        if (num.getSign() == den.getSign())
+        {
+            if (num.getSign() == 0)
             {
-                if (number[i] > 0)
-                {
-                    --number[i];
-                    break;
-                }
-                else
-                {
-                    if (i + 1 < number.size())
-                    {
-                        --number[i + 1];
-                        number[i] += 9;
-                    }
-                    else
-                    {
-                        next = -1;
-                    }
-                }
+                num = -num;
+                den = -den;
             }
         }
         else
         {
-            for (size_t i = 0; i < number.size(); ++i)
-            {
-                ++number[i];
-                next = number[i] / 10;
-                number[i] %= 10;
-                if (next == 0)
-                {
-                    break;
-                }
-            }
-            if (next != 0)
+            if (num.getSign() == 1)
             {
-                number.push_back(1);
+                num = -num;
+                den = -den;
             }
         }
-        removeLeadingZeros();
+        reduced = true;
+        shrink();
+    }
 
-        return *this;
+    // Enables lazy reduction: +=, -=, *= and /= skip normalize() while num and den have at most
+    // `digits` digits. Pass 0 to reduce after every operation again
+    static void setLazyThreshold(size_t digits)
+    {
+        lazyThreshold() = digits;
     }
 
-    BigInteger operator--(int)
+    static size_t getLazyThreshold()
     {
-        BigInteger cpy = *this;
-        --(*this);
+        return lazyThreshold();
+    }
+
+    bool isReduced() const
+    {
+        return reduced;
+    }
+
+    // numerator and denominator of the reduced form, the sign is carried by the numerator
+    BigInteger numerator() const
+    {
+        if (is_small)
+        {
+            return BigInteger(snum);
+        }
+        if (reduced)
+        {
+            return num;
+        }
+        Rational cpy = *this;
+        cpy.normalize();
+        return cpy.numerator();
+    }
+
+    BigInteger denominator() const
+    {
+        if (is_small)
+        {
+            return BigInteger(sden);
+        }
+        if (reduced)
+        {
+            return den;
+        }
+        Rational cpy = *this;
+        cpy.normalize();
+        return cpy.denominator();
+    }
+
+    static size_t combineHash(size_t a, size_t b)
+    {
+        return static_cast<size_t>(BigInteger::mixHash(a * 0x9e3779b97f4a7c15ULL + b));
+    }
+
+    void canonicalize()
+    {
+        if (!reduced)
+        {
+            normalize();
+        }
+    }
+
+    void swap(Rational &x)
+    {
+        num.swap(x.num);
+        den.swap(x.den);
+        std::swap(reduced, x.reduced);
+        std::swap(snum, x.snum);
+        std::swap(sden, x.sden);
+        std::swap(is_small, x.is_small);
+    }
+
+    Rational operator-() const
+    {
+        Rational cpy = *this;
+        cpy.negate();
         return cpy;
     }
 
-    BigInteger &operator*=(const BigInteger &x)
+    Rational &operator+=(const Rational &x)
     {
-        std::vector<uint16_t> tmp(number.size() + x.number.size() - 1, 0);
-        for (size_t i = 0; i < x.number.size(); ++i)
+        if (this == &x)
         {
-            for (size_t j = 0; j < number.size(); ++j)
-            {
-                tmp[i + j] += x.number[i] * number[j];
-            }
+            Rational cpy = x;
+            return *this += cpy;
         }
-        flatten(tmp);
-        number = tmp;
-        sign = (sign == x.sign);
-        if (number.empty())
+        BIGINTEGER_STATS_OP(RationalAdd, digitCount());
+        if (is_small && x.is_small && addSmall(x.snum, x.sden))
         {
-            number.push_back(0);
-            sign = 1;
+            return *this;
+        }
+        promote();
+        Rational storage;
+        const Rational &y = promoted(x, storage);
+        if (canUseReducedAlgorithms(y))
+        {
+            addReduced(y.num, y.den);
+            shrink();
+            return *this;
         }
-
+        num *= y.den;
+        num += y.num * den;
+        den *= y.den;
+        reduce();
         return *this;
     }
 
-    void pushFrontFrac(const uint16_t x)
+    Rational &operator-=(const Rational &x)
     {
-        if (number.empty())
+        if (this == &x)
         {
-            number.push_back(x);
-            return;
+            Rational cpy = x;
+            return *this -= cpy;
         }
-        number.push_back(0);
-        for (size_t i = number.size(); i > 0; --i)
+        BIGINTEGER_STATS_OP(RationalSub, digitCount());
+        if (is_small && x.is_small && addSmall(-x.snum, x.sden))
         {
-            number[i - 1] = number[i - 2];
+            return *this;
         }
-        number[0] = x;
+        promote();
+        Rational storage;
+        const Rational &y = promoted(x, storage);
+        if (canUseReducedAlgorithms(y))
+        {
+            addReduced(-y.num, y.den);
+            shrink();
+            return *this;
+        }
+        num *= y.den;
+        num -= y.num * den;
+        den *= y.den;
+        reduce();
+        return *this;
     }
 
-    void pushFront(const uint16_t x)
+    Rational &operator*=(const Rational &x)
     {
-        if (number.size() == 1 && number[0] == 0)
+        if (this == &x)
         {
-            number[0] = x;
-            return;
+            Rational cpy = x;
+            return *this *= cpy;
         }
-        number.push_back(0);
-        for (size_t i = number.size(); i > 0; --i)
+        BIGINTEGER_STATS_OP(RationalMul, digitCount());
+        if (is_small && x.is_small && multiplySmall(x.snum, x.sden))
         {
-            number[i - 1] = number[i - 2];
+            return *this;
         }
-        number[0] = x;
+        promote();
+        Rational storage;
+        const Rational &y = promoted(x, storage);
+        if (canUseReducedAlgorithms(y))
+        {
+            multiplyReduced(y.num, y.den);
+            shrink();
+            return *this;
+        }
+        num *= y.num;
+        den *= y.den;
+        reduce();
+        return *this;
     }
 
-    BigInteger &operator/=(const BigInteger &y)
+    // Throws std::domain_error when x is zero, as do the int64 forms of /
+    Rational &operator/=(const Rational &x)
     {
-        if (number.size() < y.number.size())
+        if (x.is_small ? x.snum == 0 : !x.num)
         {
-            *this = BigInteger(0);
-            return *this;
+            throw std::domain_error("Rational: division by zero");
         }
-        if (y == 2)
+        if (this == &x)
         {
-            number[0] /= 2;
-            if (number.size() > 1)
-            {
-                for (size_t i = 1; i < number.size() - 1; ++i)
-                {
-                    if (number[i] % 2 == 1)
-                    {
-                        number[i - 1] += 5;
-                    }
-                    number[i] /= 2;
-                }
-                if (number[number.size() - 1] % 2 == 1)
-                {
-                    number[number.size() - 2] += 5;
-                }
-                number[number.size() - 1] /= 2;
-                if (number[number.size() - 1] == 0)
-                {
-                    number.pop_back();
-                }
-            }
-            return *this;
+            Rational cpy = x;
+            return *this /= cpy;
         }
-        BigInteger q(0), rem(0), div(1, y.number);
-        bool flag_first = 0, flag_second = 0;
-        std::vector<BigInteger> divs(11);
-        divs[0] = BigInteger(0);
-        for (size_t i = 1; i < 11; ++i)
+        BIGINTEGER_STATS_OP(RationalDiv, digitCount());
+        if (is_small && x.is_small && x.snum != 0 &&
+            multiplySmall(x.snum > 0 ? x.sden : -x.sden, x.snum > 0 ? x.snum : -x.snum))
         {
-            divs[i] = divs[i - 1] + div;
+            return *this;
         }
-        size_t pos = number.size();
-        while (true)
+        promote();
+        Rational storage;
+        const Rational &y = promoted(x, storage);
+        if (canUseReducedAlgorithms(y) && y.num != 0)
         {
-            flag_second = 0;
-            while (pos > 0 && div.number > rem.number)
-            {
-                rem.pushFront(number[pos - 1]);
-                --pos;
-                if (flag_first && flag_second)
-                {
-                    q.pushFront(0);
-                }
-                flag_second = 1;
-            }
-            flag_first = 1;
-            if (pos == 0 && rem < div)
-            {
-                if (flag_second)
-                {
-                    q.pushFront(0);
-                }
-                break;
-            }
-            else
-            {
-                size_t l = 0, r = 10;
-                while (r - l > 1)
-                {
-                    if (divs[(r + l) / 2].number > rem.number)
-                    {
-                        r = (r + l) / 2;
-                    }
-                    else
-                    {
-                        l = (r + l) / 2;
-                    }
-                }
-                rem -= divs[l];
-                q.pushFront(l);
-            }
+            multiplyReduced(y.num.getSign() ? y.den : -y.den, y.num.abs());
+            shrink();
+            return *this;
         }
-        sign = (sign == y.sign);
-        number = q.number;
-
+        num *= y.den;
+        den *= y.num;
+        reduce();
         return *this;
     }
 
-    BigInteger &operator%=(const BigInteger &y)
+    // adding an integer does not change gcd(num, den), so a reduced value stays reduced
+    Rational &operator+=(int64_t y)
     {
-        if (number.size() < y.number.size())
+        BIGINTEGER_STATS_OP(RationalAdd, digitCount());
+        int64_t t;
+        if (is_small && y != std::numeric_limits<int64_t>::min() && !mulOverflow(y, sden, t) &&
+            !addOverflow(snum, t, t))
         {
+            snum = t;
             return *this;
         }
-        BigInteger q(0), rem(0), div(1, y.number);
-        bool flag_first = 0, flag_second = 0;
-        std::vector<BigInteger> divs(11);
-        divs[0] = BigInteger(0);
-        for (size_t i = 1; i < 11; ++i)
+        promote();
+        if (den == 1)
         {
-            divs[i] = divs[i - 1] + div;
+            num += y;
         }
-        size_t pos = number.size();
-        while (true)
+        else
         {
-            flag_second = 0;
-            while (pos > 0 && div.number > rem.number)
-            {
-                rem.pushFront(number[pos - 1]);
-                --pos;
-                if (flag_first && flag_second)
-                {
-                    q.pushFront(0);
-                }
-                flag_second = 1;
-            }
-            flag_first = 1;
-            if (pos == 0 && rem < div)
-            {
-                if (flag_second)
-                {
-                    q.pushFront(0);
-                }
-                break;
-            }
-            else
-            {
-                size_t l = 0, r = 10;
-                while (r - l > 1)
-                {
-                    if (divs[(r + l) / 2].number > rem.number)
-                    {
-                        r = (r + l) / 2;
-                    }
-                    else
-                    {
-                        l = (r + l) / 2;
-                    }
-                }
-                rem -= divs[l];
-                q.pushFront(l);
-            }
+            num += den * y;
         }
-        number = rem.number;
-
+        shrink();
         return *this;
     }
 
-    explicit operator bool() const
-    {
-        return !(number.size() == 1 && number[0] == 0);
-    }
-
-    std::string toString() const
+    Rational &operator-=(int64_t y)
     {
-        std::string s;
-        if (!sign)
+        BIGINTEGER_STATS_OP(RationalSub, digitCount());
+        int64_t t;
+        if (is_small && y != std::numeric_limits<int64_t>::min() && !mulOverflow(-y, sden, t) &&
+            !addOverflow(snum, t, t))
         {
-            s.push_back('-');
+            snum = t;
+            return *this;
         }
-        for (size_t i = number.size(); i > 0; --i)
+        promote();
+        if (den == 1)
         {
-            s.push_back('0' + number[i - 1]);
+            num -= y;
         }
-
-        return s;
+        else
+        {
+            num -= den * y;
+        }
+        shrink();
+        return *this;
     }
 
-    friend std::ostream &operator<<(std::ostream &out, const BigInteger &x)
+    // only gcd(den, y) can cancel, and it is a word-sized gcd
+    Rational &operator*=(int64_t y)
     {
-        out << x.toString();
-
-        return out;
+        uint64_t m = BigInteger::magnitude(y);
+        if (m > BigInteger::kSmallLimit)
+        {
+            return *this *= Rational(y);
+        }
+        BIGINTEGER_STATS_OP(RationalMul, digitCount());
+        if (m == 0)
+        {
+            *this = Rational(0);
+            return *this;
+        }
+        if (is_small && multiplySmall(y, 1))
+        {
+            return *this;
+        }
+        promote();
+        uint64_t g = std::gcd(den.remainderSmall(m), m);
+        den.divideSmall(g);
+        num *= y / static_cast<int64_t>(g);
+        shrink();
+        return *this;
     }
 
-    friend std::istream &operator>>(std::istream &in, BigInteger &x)
+    Rational &operator/=(int64_t y)
     {
-        std::string tmp;
-        in >> tmp;
-        x = BigInteger(tmp);
-
-        return in;
+        uint64_t m = BigInteger::magnitude(y);
+        if (m == 0 || m > BigInteger::kSmallLimit)
+        {
+            return *this /= Rational(y);
+        }
+        BIGINTEGER_STATS_OP(RationalDiv, digitCount());
+        if (is_small && multiplySmall(y > 0 ? 1 : -1, static_cast<int64_t>(m)))
+        {
+            return *this;
+        }
+        promote();
+        uint64_t g = std::gcd(num.remainderSmall(m), m);
+        num.divideSmall(g);
+        den.multiplySmall(m / g);
+        if (y < 0 && num)
+        {
+            num.sign = !num.sign;
+        }
+        shrink();
+        return *this;
     }
 
-    friend BigInteger operator+(const BigInteger &x, const BigInteger &y)
+    friend Rational operator+(const Rational &x, const Rational &y)
     {
-        BigInteger cpy = x;
+        Rational cpy = x;
         cpy += y;
         return cpy;
     }
 
-    friend BigInteger operator-(const BigInteger &x, const BigInteger &y)
+    friend Rational operator-(const Rational &x, const Rational &y)
     {
-        BigInteger cpy = x;
+        Rational cpy = x;
         cpy -= y;
         return cpy;
     }
 
-    friend BigInteger operator%(const BigInteger &x, const BigInteger &y)
-    {
-        BigInteger cpy = x;
-        cpy %= y;
-        return cpy;
-    }
-
-    friend BigInteger operator*(const BigInteger &x, const BigInteger &y)
+    friend Rational operator*(const Rational &x, const Rational &y)
     {
-        BigInteger cpy = x;
+        Rational cpy = x;
         cpy *= y;
         return cpy;
     }
 
-    friend BigInteger operator/(const BigInteger &x, const BigInteger &y)
+    friend Rational operator/(const Rational &x, const Rational &y)
     {
-        BigInteger cpy = x;
+        Rational cpy = x;
         cpy /= y;
         return cpy;
     }
 
-    uint16_t lastDigit() const
-    {
-        return number[0];
-    }
-
-    BigInteger abs()
+    // Three-way comparison: signs first, then the digit counts of num and den bound the
+    // magnitudes within a factor of 10, and only close values pay for the cross products
+    int compare(const Rational &x) const
     {
-        return BigInteger(1, number);
+        if (is_small && x.is_small)
+        {
+            if (sden == x.sden)
+            {
+                return (snum == x.snum) ? 0 : ((snum > x.snum) ? 1 : -1);
+            }
+#ifdef __SIZEOF_INT128__
+            __int128 lhs = static_cast<__int128>(snum) * x.sden, rhs = static_cast<__int128>(x.snum) * sden;
+            return (lhs == rhs) ? 0 : ((lhs > rhs) ? 1 : -1);
+#endif
+        }
+        if (is_small || x.is_small)
+        {
+            Rational lhs_storage, rhs_storage;
+            return promoted(*this, lhs_storage).compare(promoted(x, rhs_storage));
+        }
+        int lhs_sign = (num == 0) ? 0 : (num.getSign() ? 1 : -1);
+        int rhs_sign = (x.num == 0) ? 0 : (x.num.getSign() ? 1 : -1);
+        if (lhs_sign != rhs_sign)
+        {
+            return (lhs_sign < rhs_sign) ? -1 : 1;
+        }
+        if (lhs_sign == 0)
+        {
+            return 0;
+        }
+        if (den == x.den)
+        {
+            return (num == x.num) ? 0 : ((num > x.num) ? 1 : -1);
+        }
+        // |num| / den lies in (10^(e - 1), 10^(e + 1)) for e = digits(num) - digits(den)
+        int64_t lhs_exp = static_cast<int64_t>(num.getSize()) - static_cast<int64_t>(den.getSize());
+        int64_t rhs_exp = static_cast<int64_t>(x.num.getSize()) - static_cast<int64_t>(x.den.getSize());
+        if (lhs_exp >= rhs_exp + 2)
+        {
+            return lhs_sign;
+        }
+        if (rhs_exp >= lhs_exp + 2)
+        {
+            return -lhs_sign;
+        }
+        BigInteger lhs = num * x.den, rhs = x.num * den;
+        return (lhs == rhs) ? 0 : ((lhs > rhs) ? 1 : -1);
     }
-};
 
-bool operator>(const std::vector<uint16_t> a, const std::vector<uint16_t> b)
-{
-    if (a.size() > b.size())
-    {
-        return true;
-    }
-    else if (a.size() < b.size())
-    {
-        return false;
-    }
-    else
+    bool operator==(const Rational &x) const
     {
-        for (size_t i = a.size(); i > 0; --i)
+        if (is_small && x.is_small)
         {
-            if (a[i - 1] < b[i - 1])
-            {
-                return false;
-            }
-            else if (a[i - 1] > b[i - 1])
-            {
-                return true;
-            }
+            return snum == x.snum && sden == x.sden;
+        }
+        if (reduced && x.reduced && is_small == x.is_small)
+        {
+            return num == x.num && den == x.den;
         }
-        return false;
+        return compare(x) == 0;
     }
-}
 
-BigInteger gcd(BigInteger &a, BigInteger &b)
-{
-    if (a == 0)
-        return b;
-    if (b == 0)
-        return a;
-    if (a == b)
-        return a;
-    if (a == 1 || b == 1)
-        return 1;
-    if (a.lastDigit() % 2 == 0 && b.lastDigit() % 2 == 0)
+    bool operator!=(const Rational &x) const
     {
-        a /= 2;
-        b /= 2;
-        return 2 * gcd(a, b);
+        return !(*this == x);
     }
-    if (a.lastDigit() % 2 == 0 && b.lastDigit() % 2 != 0)
+
+    bool operator>(const Rational &x) const
     {
-        a /= 2;
-        return gcd(a, b);
+        return compare(x) > 0;
     }
 
-    if (a.lastDigit() % 2 != 0 && b.lastDigit() % 2 == 0)
+    bool operator<(const Rational &x) const
     {
-        b /= 2;
-        return gcd(a, b);
+        return compare(x) < 0;
     }
 
-    if (a < b)
+    bool operator>=(const Rational &x) const
     {
-        b -= a;
-        b /= 2;
-        return gcd(b, a);
+        return compare(x) >= 0;
     }
 
-    else
+    bool operator<=(const Rational &x) const
     {
-        a -= b;
-        a /= 2;
-        return gcd(a, b);
+        return compare(x) <= 0;
     }
-}
 
-class Rational
-{
-private:
-    BigInteger num, den;
+#ifdef __cpp_impl_three_way_comparison
+    std::strong_ordering operator<=>(const Rational &x) const
+    {
+        return compare(x) <=> 0;
+    }
 
-public:
-    Rational() = default;
+    std::strong_ordering operator<=>(int64_t y) const
+    {
+        return compare(y) <=> 0;
+    }
+#endif
 
-    Rational(int64_t a, int64_t b = 1)
+    // Hashes the reduced numerator and denominator, so the small and promoted forms of a
+    // value (and unreduced results) agree
+    size_t hash() const
     {
-        num = BigInteger(a);
-        den = BigInteger(b);
-        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
-        BigInteger tmp = gcd(tmp_num, tmp_den);
-        num /= tmp;
-        den /= tmp;
-        if (num.getSign() == den.getSign())
+        if (is_small)
         {
-            if (num.getSign() == 0)
-            {
-                num = -num;
-                den = -den;
-            }
+            return combineHash(BigInteger::hashWord(snum), BigInteger::hashWord(sden));
         }
-        else
+        if (reduced)
         {
-            if (num.getSign() == 1)
-            {
-                num = -num;
-                den = -den;
-            }
+            return combineHash(num.hash(), den.hash());
         }
+        Rational cpy = *this;
+        cpy.normalize();
+        return cpy.hash();
     }
 
-    Rational(BigInteger a, BigInteger b = 1)
+    int compare(int64_t y) const
     {
-        num = a, den = b;
-        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
-        BigInteger tmp = gcd(tmp_num, tmp_den);
-        num /= tmp;
-        den /= tmp;
-        if (num.getSign() == den.getSign())
+        if (is_small)
         {
-            if (num.getSign() == 0)
+            int64_t rhs;
+            if (sden == 1 || !mulOverflow(y, sden, rhs))
             {
-                num = -num;
-                den = -den;
+                rhs = (sden == 1) ? y : rhs;
+                return (snum == rhs) ? 0 : ((snum > rhs) ? 1 : -1);
             }
+            Rational cpy = *this;
+            cpy.promote();
+            return cpy.compare(y);
         }
-        else
+        if (den == 1)
         {
-            if (num.getSign() == 1)
-            {
-                num = -num;
-                den = -den;
-            }
+            return num.compare(y);
         }
-    }
-
-    Rational &operator=(Rational x)
-    {
-        swap(x);
-        return *this;
-    }
-
-    void normalize()
-    {
-        BigInteger tmp_num = num.abs(), tmp_den = den.abs();
-        BigInteger tmp = gcd(tmp_num, tmp_den);
-        num /= tmp;
-        den /= tmp;
-        if (num.getSign() == den.getSign())
+        if (num.getSign() != (y >= 0))
         {
-            if (num.getSign() == 0)
-            {
-                num = -num;
-                den = -den;
-            }
+            return num.getSign() ? 1 : -1;
         }
-        else
+        BigInteger rhs = den * y;
+        if (num == rhs)
         {
-            if (num.getSign() == 1)
-            {
-                num = -num;
-                den = -den;
-            }
+            return 0;
         }
+        return (num > rhs) ? 1 : -1;
     }
 
-    void swap(Rational &x)
+    bool operator==(int64_t y) const
     {
-        num.swap(x.num);
-        den.swap(x.den);
+        if (is_small)
+        {
+            return sden == 1 && snum == y;
+        }
+        return reduced ? (den == 1 && num == y) : compare(y) == 0;
     }
 
-    Rational operator-()
+    bool operator!=(int64_t y) const
     {
-        return Rational(-num, den);
+        return !(*this == y);
     }
 
-    Rational &operator+=(const Rational &x)
+    bool operator<(int64_t y) const
     {
-        num *= x.den;
-        num += x.num * den;
-        den *= x.den;
-        normalize();
-        return *this;
+        return compare(y) < 0;
     }
 
-    Rational &operator-=(const Rational &x)
+    bool operator>(int64_t y) const
     {
-        num *= x.den;
-        num -= x.num * den;
-        den *= x.den;
-        normalize();
-        return *this;
+        return compare(y) > 0;
     }
 
-    Rational &operator*=(const Rational &x)
+    bool operator<=(int64_t y) const
     {
-        BigInteger tmp_num = x.num, tmp_den = x.den;
-        num *= tmp_num;
-        den *= tmp_den;
-        normalize();
-        return *this;
+        return compare(y) <= 0;
     }
 
-    Rational &operator/=(const Rational &x)
+    bool operator>=(int64_t y) const
     {
-        BigInteger tmp_num = x.num, tmp_den = x.den;
-        num *= tmp_den;
-        den *= tmp_num;
-        normalize();
-        return *this;
+        return compare(y) >= 0;
     }
 
-    friend Rational operator+(const Rational &x, const Rational &y)
+    friend Rational operator+(const Rational &x, int64_t y)
     {
         Rational cpy = x;
         cpy += y;
         return cpy;
     }
 
-    friend Rational operator-(const Rational &x, const Rational &y)
+    friend Rational operator+(int64_t x, const Rational &y)
+    {
+        Rational cpy = y;
+        cpy += x;
+        return cpy;
+    }
+
+    friend Rational operator-(const Rational &x, int64_t y)
     {
         Rational cpy = x;
         cpy -= y;
         return cpy;
     }
 
-    friend Rational operator*(const Rational &x, const Rational &y)
+    friend Rational operator-(int64_t x, const Rational &y)
     {
-        Rational cpy = x;
-        cpy *= y;
+        Rational cpy = y;
+        cpy.negate();
+        cpy += x;
         return cpy;
     }
 
-    friend Rational operator/(const Rational &x, const Rational &y)
+    friend Rational operator*(const Rational &x, int64_t y)
     {
         Rational cpy = x;
-        cpy /= y;
+        cpy *= y;
         return cpy;
     }
 
-    bool operator==(const Rational &x) const
+    friend Rational operator*(int64_t x, const Rational &y)
     {
-        return (num * x.den == den * x.num);
+        Rational cpy = y;
+        cpy *= x;
+        return cpy;
     }
 
-    bool operator!=(const Rational &x) const
+    friend Rational operator/(const Rational &x, int64_t y)
     {
-        return !(*this == x);
+        Rational cpy = x;
+        cpy /= y;
+        return cpy;
     }
 
-    bool operator>(const Rational &x) const
+    friend Rational operator/(int64_t x, const Rational &y)
     {
-        bool sgl = (num.getSign() == den.getSign() || num == 0);
-        bool sgr = (x.num.getSign() == x.den.getSign() || x.num == 0);
-        if (sgl > sgr)
-        {
-            return true;
-        }
-        else if (sgl < sgr)
+        if (y.is_small ? y.snum == 0 : !y.num)
         {
-            return false;
+            throw std::domain_error("Rational: division by zero");
         }
-        else
+        Rational cpy = y;
+        cpy.promote();
+        cpy.num.swap(cpy.den);
+        if (!cpy.den.getSign())
         {
-            if (sgl)
-            {
-                return (num * x.den > den * x.num);
-            }
-            else
-            {
-                return !(num * x.den > den * x.num);
-            }
+            cpy.num = -cpy.num;
+            cpy.den = -cpy.den;
         }
+        cpy *= x;
+        return cpy;
     }
 
-    bool operator<(const Rational &x) const
+    friend bool operator==(int64_t x, const Rational &y)
     {
-        return x > *this;
+        return y == x;
     }
 
-    bool operator>=(const Rational &x) const
+    friend bool operator!=(int64_t x, const Rational &y)
     {
-        return (*this > x || *this == x);
+        return y != x;
     }
 
-    bool operator<=(const Rational &x) const
+    friend bool operator<(int64_t x, const Rational &y)
+    {
+        return y.compare(x) > 0;
+    }
+
+    friend bool operator>(int64_t x, const Rational &y)
     {
-        return (*this < x || *this == x);
+        return y.compare(x) < 0;
+    }
+
+    friend bool operator<=(int64_t x, const Rational &y)
+    {
+        return y.compare(x) >= 0;
+    }
+
+    friend bool operator>=(int64_t x, const Rational &y)
+    {
+        return y.compare(x) <= 0;
     }
 
     std::string toString()
     {
+        canonicalize();
+        if (is_small)
+        {
+            return (sden == 1) ? std::to_string(snum) : std::to_string(snum) + "/" + std::to_string(sden);
+        }
         if (num == 0)
         {
             return "0";
@@ -1035,37 +3184,62 @@ public:
         return num.toString() + "/" + den.toString();
     }
 
-    std::string asDecimal(size_t precision = 0)
+    // Lazily produces the digits after the decimal point of rem / den (0 <= rem < den).
+    // Each digit costs one shift and at most one subtraction of a precomputed multiple of
+    // den, and the generator notices when the remainders start repeating.
+    class DecimalDigits
     {
-        BigInteger q = num / den, p = (num.getSign()) ? num % den : -(num % den), tmp;
+    private:
+        BigInteger rem_, period_start_;
+        std::vector<BigInteger> multiples_; // k * den for k = 0..10
+        size_t preperiod_ = 0, position_ = 0, period_ = 0;
 
-        if (precision == 0)
+    public:
+        DecimalDigits(const BigInteger &rem, const BigInteger &den) : rem_(rem), multiples_(11)
         {
-            return q.toString();
+            multiples_[0] = 0;
+            for (size_t i = 1; i < 11; ++i)
+            {
+                multiples_[i] = multiples_[i - 1] + den;
+            }
+            // the repetend starts after max(a, b) digits for den = 2^a * 5^b * d
+            BigInteger d = den;
+            size_t twos = 0, fives = 0;
+            while (d.lastDigit() % 2 == 0)
+            {
+                d /= 2;
+                ++twos;
+            }
+            while (d.lastDigit() % 5 == 0)
+            {
+                d /= 5;
+                ++fives;
+            }
+            preperiod_ = std::max(twos, fives);
+            if (preperiod_ == 0)
+            {
+                period_start_ = rem_;
+            }
         }
-        bool flag_first;
-        std::vector<BigInteger> divs(11);
-        divs[0] = BigInteger(0);
-        for (size_t i = 1; i < 11; ++i)
+
+        // true once the expansion has terminated, every further digit is 0
+        bool done() const
         {
-            divs[i] = divs[i - 1] + den;
+            return rem_ == 0;
         }
-        while (precision > tmp.getSize() && p != 0)
+
+        uint16_t next()
         {
-            flag_first = 0;
-            while (den > p)
+            if (rem_ == 0)
             {
-                p.pushFront(0);
-                if (flag_first)
-                {
-                    tmp.pushFrontFrac(0);
-                }
-                flag_first = 1;
+                ++position_;
+                return 0;
             }
+            rem_.pushFront(0);
             size_t l = 0, r = 10;
             while (r - l > 1)
             {
-                if (divs[(r + l) / 2] > p)
+                if (multiples_[(r + l) / 2] > rem_)
                 {
                     r = (r + l) / 2;
                 }
@@ -1074,25 +3248,192 @@ public:
                     l = (r + l) / 2;
                 }
             }
-            p -= divs[l];
-            tmp.pushFrontFrac(l);
+            rem_ -= multiples_[l];
+            ++position_;
+            if (period_ == 0 && position_ >= preperiod_ && rem_ != 0)
+            {
+                if (position_ == preperiod_)
+                {
+                    period_start_ = rem_;
+                }
+                else if (rem_ == period_start_)
+                {
+                    period_ = position_ - preperiod_;
+                }
+            }
+            return l;
         }
-        while (precision > tmp.getSize())
+
+        // number of digits produced so far
+        size_t position() const
+        {
+            return position_;
+        }
+
+        // digits before the repeating part
+        size_t preperiod() const
+        {
+            return preperiod_;
+        }
+
+        // length of the repeating part, 0 until one full period has been produced
+        size_t period() const
+        {
+            return period_;
+        }
+    };
+
+    // digits of the fractional part of |*this|
+    DecimalDigits decimalDigits() const
+    {
+        if (is_small)
+        {
+            return DecimalDigits(BigInteger(snum % sden).abs(), BigInteger(sden));
+        }
+        if (!reduced)
+        {
+            Rational cpy = *this;
+            cpy.normalize();
+            return cpy.decimalDigits();
+        }
+        BigInteger rem = num % den;
+        return DecimalDigits(rem.abs(), den);
+    }
+
+    std::string asDecimal(size_t precision = 0)
+    {
+        if (is_small)
+        {
+            Rational cpy = *this;
+            cpy.promote();
+            return cpy.asDecimal(precision);
+        }
+        BigInteger q = num / den;
+
+        if (precision == 0)
+        {
+            return q.toString();
+        }
+        std::string res;
+        res.reserve(q.getSize() + precision + 2);
+        if (q == 0 && !num.getSign())
+        {
+            res.push_back('-');
+        }
+        res += q.toString();
+        res.push_back('.');
+        DecimalDigits digits = decimalDigits();
+        for (size_t i = 0; i < precision; ++i)
+        {
+            res.push_back('0' + digits.next());
+        }
+        return res;
+    }
+
+    // Terms [a0; a1, a2, ...] of the continued fraction, a0 = floor(*this)
+    std::vector<BigInteger> continuedFraction() const
+    {
+        std::vector<BigInteger> terms;
+        BigInteger n = numerator(), d = denominator();
+        while (d != 0)
+        {
+            BigInteger q = n / d;
+            BigInteger r = n - q * d;
+            if (!r.getSign())
+            {
+                --q;
+                r += d;
+            }
+            terms.push_back(q);
+            n.swap(d);
+            d.swap(r);
+        }
+        return terms;
+    }
+
+    // Closest fraction with denominator at most max_den (the classical convergent and
+    // semiconvergent search), used to keep operands in a bounded size class.
+    // Throws std::invalid_argument if max_den < 1
+    Rational limitDenominator(const BigInteger &max_den) const
+    {
+        if (max_den < 1)
         {
-            tmp.pushFrontFrac(0);
+            throw std::invalid_argument("Rational: max_den must be at least 1");
         }
-        if (q == 0)
+        Rational x = *this;
+        x.canonicalize();
+        x.promote();
+        if (x.den <= max_den)
         {
-            if (num.getSign() != den.getSign())
+            return x;
+        }
+        BigInteger p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+        BigInteger n = x.num.abs(), d = x.den;
+        while (true)
+        {
+            BigInteger a = n / d;
+            BigInteger q2 = q0 + a * q1;
+            if (q2 > max_den)
             {
-                return "-" + q.toString() + "." + tmp.toString();
+                break;
             }
+            BigInteger p2 = p0 + a * p1;
+            p0.swap(p1);
+            p1.swap(p2);
+            q0.swap(q1);
+            q1.swap(q2);
+            BigInteger r = n - a * d;
+            n.swap(d);
+            d.swap(r);
+        }
+        BigInteger k = (max_den - q0) / q1;
+        Rational bound1(p0 + k * p1, q0 + k * q1), bound2(p1, q1);
+        Rational target(x.num.abs(), x.den);
+        Rational dist1 = bound1 - target, dist2 = bound2 - target;
+        if (dist1 < 0)
+        {
+            dist1 = -dist1;
+        }
+        if (dist2 < 0)
+        {
+            dist2 = -dist2;
         }
-        return q.toString() + "." + tmp.toString();
+        Rational res = (dist2 <= dist1) ? bound2 : bound1;
+        if (!x.num.getSign())
+        {
+            res = -res;
+        }
+        return res;
+    }
+
+    explicit operator double() const
+    {
+        return toFloatingPoint<double>();
+    }
+
+    explicit operator float() const
+    {
+        return toFloatingPoint<float>();
     }
+};
+
+namespace std
+{
+template <>
+struct hash<BigInteger>
+{
+    size_t operator()(const BigInteger &x) const
+    {
+        return x.hash();
+    }
+};
 
-    explicit operator double()
+template <>
+struct hash<Rational>
+{
+    size_t operator()(const Rational &x) const
     {
-        return std::stod(asDecimal(100));
+        return x.hash();
     }
 };
+} // namespace std
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "batch.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Line-oriented calculator front end: every line is one expression, parsed straight into
+// Batch nodes so that a whole block of lines is evaluated (and deduplicated) together.
+//
+// Infix syntax: + - * / with the usual precedence, unary minus, parentheses and x^k with
+// an integer literal exponent (negative only over Rational). Decimal literals such as 1.25
+// are accepted over Rational. RPN syntax takes whitespace separated numbers and the
+// operators + - * / and `neg`. Over BigInteger, / truncates like BigInteger::operator/.
+template <typename T>
+class Calculator
+{
+public:
+    enum class Syntax
+    {
+        Infix,
+        Rpn
+    };
+
+private:
+    using Expr = typename Batch<T>::Expr;
+
+    Syntax syntax_;
+    size_t threads_;
+
+    class InfixParser
+    {
+    private:
+        Batch<T> &batch_;
+        std::string_view line_;
+        size_t pos_ = 0;
+
+        [[noreturn]] void fail(const std::string &what) const
+        {
+            throw std::invalid_argument(what + " at column " + std::to_string(pos_ + 1));
+        }
+
+        char peek()
+        {
+            while (pos_ < line_.size() && (line_[pos_] == ' ' || line_[pos_] == '\t' || line_[pos_] == '\r'))
+            {
+                ++pos_;
+            }
+            return pos_ < line_.size() ? line_[pos_] : '\0';
+        }
+
+        static bool isDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        Expr number()
+        {
+            size_t start = pos_;
+            while (pos_ < line_.size() && isDigit(line_[pos_]))
+            {
+                ++pos_;
+            }
+            return literal(batch_, line_.substr(start, pos_ - start), line_.substr(pos_), pos_);
+        }
+
+        Expr primary()
+        {
+            char c = peek();
+            if (c == '(')
+            {
+                ++pos_;
+                Expr e = expression();
+                if (peek() != ')')
+                {
+                    fail("expected ')'");
+                }
+                ++pos_;
+                return e;
+            }
+            if (!isDigit(c))
+            {
+                fail(c == '\0' ? "unexpected end of expression" : std::string("unexpected '") + c + "'");
+            }
+            return number();
+        }
+
+        Expr power()
+        {
+            Expr base = primary();
+            if (peek() != '^')
+            {
+                return base;
+            }
+            ++pos_;
+            bool negative = false;
+            if (peek() == '-')
+            {
+                negative = true;
+                ++pos_;
+            }
+            size_t start = pos_;
+            unsigned long long k = 0;
+            while (pos_ < line_.size() && isDigit(line_[pos_]))
+            {
+                if (k > (std::numeric_limits<unsigned long long>::max() - 9) / 10)
+                {
+                    fail("exponent too large");
+                }
+                k = k * 10 + (line_[pos_++] - '0');
+            }
+            if (pos_ == start)
+            {
+                fail("exponent must be an integer literal");
+            }
+            return raise(batch_, base, k, negative);
+        }
+
+        Expr unary()
+        {
+            if (peek() == '-')
+            {
+                ++pos_;
+                return batch_.negate(unary());
+            }
+            if (peek() == '+')
+            {
+                ++pos_;
+                return unary();
+            }
+            return power();
+        }
+
+        Expr term()
+        {
+            Expr e = unary();
+            for (char c = peek(); c == '*' || c == '/'; c = peek())
+            {
+                ++pos_;
+                Expr rhs = unary();
+                e = (c == '*') ? batch_.multiply(e, rhs) : batch_.divide(e, rhs);
+            }
+            return e;
+        }
+
+        Expr expression()
+        {
+            Expr e = term();
+            for (char c = peek(); c == '+' || c == '-'; c = peek())
+            {
+                ++pos_;
+                Expr rhs = term();
+                e = (c == '+') ? batch_.add(e, rhs) : batch_.subtract(e, rhs);
+            }
+            return e;
+        }
+
+    public:
+        InfixParser(Batch<T> &batch, std::string_view line) : batch_(batch), line_(line)
+        {
+        }
+
+        Expr parse()
+        {
+            Expr e = expression();
+            if (peek() != '\0')
+            {
+                fail(std::string("unexpected '") + line_[pos_] + "'");
+            }
+            return e;
+        }
+    };
+
+    // Builds the node for a literal whose integer part is `digits`; `rest` starts right
+    // after it and may hold a fractional part, `pos` is advanced past whatever is consumed
+    static Expr literal(Batch<T> &batch, std::string_view digits, std::string_view rest, size_t &pos)
+    {
+        if (rest.empty() || rest[0] != '.')
+        {
+            return batch.constant(T(BigInteger(std::string(digits))));
+        }
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            size_t frac = 1;
+            while (frac < rest.size() && rest[frac] >= '0' && rest[frac] <= '9')
+            {
+                ++frac;
+            }
+            BigInteger mantissa(std::string(digits) + std::string(rest.substr(1, frac - 1)));
+            BigInteger scale = 1;
+            scale.multiplyPow10(frac - 1);
+            pos += frac;
+            return batch.constant(Rational(mantissa, scale));
+        }
+        else
+        {
+            throw std::invalid_argument("decimal literal in integer mode at column " + std::to_string(pos + 1));
+        }
+    }
+
+    // base^k by square-and-multiply, the squares are shared nodes of the batch
+    static Expr raise(Batch<T> &batch, Expr base, unsigned long long k, bool negative)
+    {
+        if (negative && !std::is_same<T, Rational>::value)
+        {
+            throw std::invalid_argument("negative exponent in integer mode");
+        }
+        Expr res = batch.constant(T(1));
+        bool first = true;
+        for (; k > 0; k >>= 1)
+        {
+            if (k & 1)
+            {
+                res = first ? base : batch.multiply(res, base);
+                first = false;
+            }
+            if (k > 1)
+            {
+                base = batch.multiply(base, base);
+            }
+        }
+        return negative ? batch.divide(batch.constant(T(1)), res) : res;
+    }
+
+    static Expr parseRpn(Batch<T> &batch, std::string_view line)
+    {
+        std::vector<Expr> stack;
+        size_t pos = 0;
+        while (true)
+        {
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+            {
+                ++pos;
+            }
+            if (pos == line.size())
+            {
+                break;
+            }
+            size_t start = pos;
+            while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r')
+            {
+                ++pos;
+            }
+            std::string_view token = line.substr(start, pos - start);
+            std::string where = " at column " + std::to_string(start + 1);
+            if (token[0] >= '0' && token[0] <= '9')
+            {
+                size_t digits = 0;
+                while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9')
+                {
+                    ++digits;
+                }
+                size_t end = start + digits;
+                stack.push_back(literal(batch, token.substr(0, digits), token.substr(digits), end));
+                if (end != pos)
+                {
+                    throw std::invalid_argument("malformed number" + where);
+                }
+                continue;
+            }
+            if (token == "neg")
+            {
+                if (stack.empty())
+                {
+                    throw std::invalid_argument("stack underflow" + where);
+                }
+                stack.back() = batch.negate(stack.back());
+                continue;
+            }
+            if (token.size() != 1 || std::string_view("+-*/").find(token[0]) == std::string_view::npos)
+            {
+                throw std::invalid_argument("unknown token '" + std::string(token) + "'" + where);
+            }
+            if (stack.size() < 2)
+            {
+                throw std::invalid_argument("stack underflow" + where);
+            }
+            Expr rhs = stack.back();
+            stack.pop_back();
+            Expr &lhs = stack.back();
+            switch (token[0])
+            {
+            case '+':
+                lhs = batch.add(lhs, rhs);
+                break;
+            case '-':
+                lhs = batch.subtract(lhs, rhs);
+                break;
+            case '*':
+                lhs = batch.multiply(lhs, rhs);
+                break;
+            default:
+                lhs = batch.divide(lhs, rhs);
+                break;
+            }
+        }
+        if (stack.size() != 1)
+        {
+            throw std::invalid_argument(stack.empty() ? "empty expression" : "unused operands");
+        }
+        return stack.back();
+    }
+
+    static std::string format(T &x)
+    {
+        return x.toString();
+    }
+
+    static bool blank(std::string_view line)
+    {
+        return line.find_first_not_of(" \t\r") == std::string_view::npos;
+    }
+
+public:
+    explicit Calculator(Syntax syntax = Syntax::Infix, size_t threads = 1) : syntax_(syntax), threads_(threads)
+    {
+    }
+
+    Expr parse(Batch<T> &batch, std::string_view line) const
+    {
+        return (syntax_ == Syntax::Infix) ? InfixParser(batch, line).parse() : parseRpn(batch, line);
+    }
+
+    // Appends one output line per non-blank input line: the value, or "error: " and the
+    // reason. All lines share one batch; if its evaluation fails the lines are redone one
+    // at a time so that only the offending ones report the error.
+    void evaluate(const std::vector<std::string_view> &lines, std::string &out) const
+    {
+        Batch<T> batch;
+        std::vector<std::string> errors;
+        for (std::string_view line : lines)
+        {
+            if (blank(line))
+            {
+                continue;
+            }
+            try
+            {
+                batch.submit(parse(batch, line));
+                errors.emplace_back();
+            }
+            catch (const std::exception &e)
+            {
+                errors.emplace_back(e.what());
+            }
+        }
+        std::vector<T> values;
+        bool isolated = false;
+        try
+        {
+            values = batch.evaluate(threads_);
+        }
+        catch (const std::exception &)
+        {
+            isolated = true;
+        }
+        size_t next = 0, index = 0;
+        for (std::string_view line : lines)
+        {
+            if (blank(line))
+            {
+                continue;
+            }
+            const std::string &error = errors[index++];
+            if (!error.empty())
+            {
+                out += "error: " + error + "\n";
+                continue;
+            }
+            if (!isolated)
+            {
+                out += format(values[next++]);
+                out += '\n';
+                continue;
+            }
+            try
+            {
+                Batch<T> single;
+                single.submit(parse(single, line));
+                out += format(single.evaluate(1)[0]);
+                out += '\n';
+            }
+            catch (const std::exception &e)
+            {
+                out += "error: " + std::string(e.what()) + "\n";
+            }
+        }
+    }
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "biginteger.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Modulus shared by a family of ModInt values together with its Barrett constant. With
+// k = digits(n) and mu = floor(10^2k / n), any 0 <= x < 10^2k (every product of two reduced
+// values) is reduced by two products, two digit shifts (BigInteger is base 10, so dividing
+// by 10^j drops j digits) and at most two subtractions instead of a long division.
+class ModContext
+{
+private:
+    BigInteger modulus_, mu_;
+    size_t k_;
+
+public:
+    explicit ModContext(const BigInteger &n) : modulus_(n), k_(n.getSize())
+    {
+        if (n < 2)
+        {
+            throw std::invalid_argument("ModContext: modulus must be at least 2");
+        }
+        BigInteger power = 1;
+        power.multiplyPow10(2 * k_);
+        mu_ = power / n;
+    }
+
+    const BigInteger &modulus() const
+    {
+        return modulus_;
+    }
+
+    // x mod n for 0 <= x < 10^2k
+    BigInteger reduce(const BigInteger &x) const
+    {
+        if (x < modulus_)
+        {
+            return x;
+        }
+        BigInteger q = x;
+        q.dividePow10(k_ - 1);
+        q *= mu_;
+        q.dividePow10(k_ + 1);
+        q *= modulus_;
+        BigInteger r = x - q;
+        while (r >= modulus_)
+        {
+            r -= modulus_;
+        }
+        return r;
+    }
+
+    // x mod n in [0, n) for any x
+    BigInteger reduceAny(const BigInteger &x) const
+    {
+        if (x >= 0 && x.getSize() <= 2 * k_)
+        {
+            return reduce(x);
+        }
+        BigInteger r = x % modulus_;
+        if (r < 0)
+        {
+            r += modulus_;
+        }
+        return r;
+    }
+};
+
+// Element of Z/nZ, kept reduced to [0, n). Values bound to different contexts can only be
+// combined if their moduli are equal; anything else throws std::invalid_argument.
+class ModInt
+{
+private:
+    std::shared_ptr<const ModContext> context_;
+    BigInteger value_;
+
+    ModInt(std::shared_ptr<const ModContext> context, BigInteger value, bool)
+        : context_(std::move(context)), value_(std::move(value))
+    {
+    }
+
+    const ModContext &checkContext(const ModInt &x) const
+    {
+        if (context_ != x.context_ && context_->modulus() != x.context_->modulus())
+        {
+            throw std::invalid_argument("ModInt: operands have different moduli");
+        }
+        return *context_;
+    }
+
+public:
+    ModInt(std::shared_ptr<const ModContext> context, const BigInteger &x = 0) : context_(std::move(context))
+    {
+        if (!context_)
+        {
+            throw std::invalid_argument("ModInt: no modulus context");
+        }
+        value_ = context_->reduceAny(x);
+    }
+
+    const BigInteger &getValue() const
+    {
+        return value_;
+    }
+
+    const std::shared_ptr<const ModContext> &getContext() const
+    {
+        return context_;
+    }
+
+    const BigInteger &modulus() const
+    {
+        return context_->modulus();
+    }
+
+    ModInt &operator+=(const ModInt &x)
+    {
+        const ModContext &ctx = checkContext(x);
+        value_ += x.value_;
+        if (value_ >= ctx.modulus())
+        {
+            value_ -= ctx.modulus();
+        }
+        return *this;
+    }
+
+    ModInt &operator-=(const ModInt &x)
+    {
+        const ModContext &ctx = checkContext(x);
+        value_ -= x.value_;
+        if (value_ < 0)
+        {
+            value_ += ctx.modulus();
+        }
+        return *this;
+    }
+
+    ModInt &operator*=(const ModInt &x)
+    {
+        const ModContext &ctx = checkContext(x);
+        value_ *= x.value_;
+        value_ = ctx.reduce(value_);
+        return *this;
+    }
+
+    // Multiplication by the inverse, throws std::domain_error if x is not invertible
+    ModInt &operator/=(const ModInt &x)
+    {
+        checkContext(x);
+        return *this *= x.inverse();
+    }
+
+    ModInt operator-() const
+    {
+        if (value_ == 0)
+        {
+            return *this;
+        }
+        return ModInt(context_, context_->modulus() - value_, true);
+    }
+
+    friend ModInt operator+(const ModInt &x, const ModInt &y)
+    {
+        ModInt res = x;
+        res += y;
+        return res;
+    }
+
+    friend ModInt operator-(const ModInt &x, const ModInt &y)
+    {
+        ModInt res = x;
+        res -= y;
+        return res;
+    }
+
+    friend ModInt operator*(const ModInt &x, const ModInt &y)
+    {
+        ModInt res = x;
+        res *= y;
+        return res;
+    }
+
+    friend ModInt operator/(const ModInt &x, const ModInt &y)
+    {
+        ModInt res = x;
+        res /= y;
+        return res;
+    }
+
+    bool operator==(const ModInt &x) const
+    {
+        return value_ == x.value_ && (context_ == x.context_ || context_->modulus() == x.context_->modulus());
+    }
+
+    bool operator!=(const ModInt &x) const
+    {
+        return !(*this == x);
+    }
+
+    // Inverse by the extended Euclidean algorithm, std::domain_error when gcd(x, n) != 1
+    ModInt inverse() const
+    {
+        BigInteger r0 = context_->modulus(), r1 = value_;
+        BigInteger t0 = 0, t1 = 1;
+        while (r1 != 0)
+        {
+            BigInteger q = r0 / r1;
+            BigInteger r2 = r0 - q * r1, t2 = t0 - q * t1;
+            r0.swap(r1);
+            r1.swap(r2);
+            t0.swap(t1);
+            t1.swap(t2);
+        }
+        if (r0 != 1)
+        {
+            throw std::domain_error("ModInt: value is not invertible");
+        }
+        if (t0 < 0)
+        {
+            t0 += context_->modulus();
+        }
+        return ModInt(context_, t0, true);
+    }
+
+    // x^e for e >= 0, processing e one decimal digit at a time: res = res^10 * x^d
+    ModInt pow(const BigInteger &e) const
+    {
+        if (e < 0)
+        {
+            throw std::invalid_argument("ModInt: negative exponent");
+        }
+        std::vector<ModInt> powers(10, ModInt(context_, 1));
+        for (size_t d = 1; d < 10; ++d)
+        {
+            powers[d] = powers[d - 1] * *this;
+        }
+        ModInt res(context_, 1);
+        const BigIntegerDigits &digits = e.getDigits();
+        for (size_t i = digits.size(); i > 0; --i)
+        {
+            ModInt square = res * res, fourth = square * square;
+            res = fourth * fourth * square; // res^10
+            if (digits[i - 1] != 0)
+            {
+                res *= powers[digits[i - 1]];
+            }
+        }
+        return res;
+    }
+
+    // Inverts every element with a single extended gcd (Montgomery's trick): prefix
+    // products forward, one inversion, then peel the factors off backwards. Throws
+    // std::domain_error if any element is not invertible.
+    static std::vector<ModInt> batchInverse(const std::vector<ModInt> &xs)
+    {
+        if (xs.empty())
+        {
+            return {};
+        }
+        std::vector<ModInt> prefix;
+        prefix.reserve(xs.size());
+        prefix.push_back(xs[0]);
+        for (size_t i = 1; i < xs.size(); ++i)
+        {
+            prefix.push_back(prefix.back() * xs[i]);
+        }
+        ModInt inv = prefix.back().inverse();
+        std::vector<ModInt> res(xs.size(), inv);
+        for (size_t i = xs.size() - 1; i > 0; --i)
+        {
+            res[i] = inv * prefix[i - 1];
+            inv *= xs[i];
+        }
+        res[0] = inv;
+        return res;
+    }
+
+    std::string toString() const
+    {
+        return value_.toString();
+    }
+
+    friend std::ostream &operator<<(std::ostream &out, const ModInt &x)
+    {
+        return out << x.value_;
+    }
+};
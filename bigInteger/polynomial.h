@@ -0,0 +1,505 @@
+#pragma once
+
+#include "biginteger.h"
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Dense polynomial over BigInteger or Rational, coefficients stored lowest degree first with
+// no trailing zeros (the zero polynomial has none). Long products go through Kronecker
+// substitution: both operands are packed into one BigInteger at x = 10^k, so a single big
+// multiplication replaces the d^2 coefficient products. Division by a polynomial with a unit
+// leading coefficient uses a Newton power-series inverse built from the same products.
+template <typename T>
+class Polynomial
+{
+    static_assert(std::is_same<T, BigInteger>::value || std::is_same<T, Rational>::value,
+                  "Polynomial supports BigInteger and Rational coefficients");
+
+private:
+    std::vector<T> coefficients_;
+
+    // operands with fewer terms are multiplied term by term
+    static constexpr size_t kKroneckerTerms = 8;
+    // quotients shorter than this are found by long division
+    static constexpr size_t kNewtonTerms = 32;
+
+    void trim()
+    {
+        while (!coefficients_.empty() && coefficients_.back() == 0)
+        {
+            coefficients_.pop_back();
+        }
+    }
+
+    // Clears denominators: out = c * scale with integer entries, returns scale (1 for BigInteger)
+    static BigInteger toIntegers(const std::vector<T> &c, std::vector<BigInteger> &out)
+    {
+        BigInteger scale = 1;
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            for (const Rational &x : c)
+            {
+                BigInteger d = x.denominator();
+                if (d != 1)
+                {
+                    BigInteger a = scale, b = d;
+                    scale *= d / gcd(a, b);
+                }
+            }
+            out.clear();
+            out.reserve(c.size());
+            for (const Rational &x : c)
+            {
+                out.push_back(x.numerator() * (scale / x.denominator()));
+            }
+        }
+        else
+        {
+            out = c;
+        }
+        return scale;
+    }
+
+    static std::vector<T> fromIntegers(std::vector<BigInteger> &c, const BigInteger &scale)
+    {
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            std::vector<Rational> res;
+            res.reserve(c.size());
+            for (BigInteger &x : c)
+            {
+                res.push_back(Rational(x, scale));
+            }
+            return res;
+        }
+        else
+        {
+            return std::move(c);
+        }
+    }
+
+    static size_t digitCount(uint64_t x)
+    {
+        size_t digits = 1;
+        while (x >= 10)
+        {
+            x /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+    static size_t maxDigits(const std::vector<BigInteger> &c)
+    {
+        size_t res = 1;
+        for (const BigInteger &x : c)
+        {
+            res = std::max(res, x.getSize());
+        }
+        return res;
+    }
+
+    // sum c_i * 10^(k i): every |c_i| is copied into its own k-digit slot, negative
+    // coefficients go to a second number that is subtracted once
+    static BigInteger pack(const std::vector<BigInteger> &c, size_t k)
+    {
+        BigIntegerDigits positive(c.size() * k, 0), negative;
+        for (size_t i = 0; i < c.size(); ++i)
+        {
+            const BigIntegerDigits &digits = c[i].getDigits();
+            if (!c[i].getSign())
+            {
+                if (negative.empty())
+                {
+                    negative.assign(c.size() * k, 0);
+                }
+                std::copy(digits.begin(), digits.end(), negative.begin() + i * k);
+            }
+            else
+            {
+                std::copy(digits.begin(), digits.end(), positive.begin() + i * k);
+            }
+        }
+        BigInteger res(true, positive);
+        res.removeLeadingZeros();
+        if (!negative.empty())
+        {
+            BigInteger neg(true, negative);
+            neg.removeLeadingZeros();
+            res -= neg;
+        }
+        return res;
+    }
+
+    // inverse of pack() for coefficients with |c_i| < 10^k / 2: a slot at or above the half
+    // is a negative coefficient that borrowed one from the next slot
+    static std::vector<BigInteger> unpack(const BigInteger &v, size_t k, size_t count)
+    {
+        const BigIntegerDigits &digits = v.getDigits();
+        bool negative = !v.getSign();
+        BigInteger half = 5, full = 1;
+        half.multiplyPow10(k - 1);
+        full.multiplyPow10(k);
+        std::vector<BigInteger> res(count);
+        bool carry = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t from = std::min(i * k, digits.size()), to = std::min(from + k, digits.size());
+            BigIntegerDigits slot(digits.begin() + from, digits.begin() + to);
+            BigInteger c(true, slot);
+            c.removeLeadingZeros();
+            if (carry)
+            {
+                c += 1;
+            }
+            carry = c >= half;
+            if (carry)
+            {
+                c -= full;
+            }
+            res[i] = negative ? -c : c;
+        }
+        return res;
+    }
+
+    static std::vector<BigInteger> multiplyIntegers(const std::vector<BigInteger> &a, const std::vector<BigInteger> &b)
+    {
+        if (a.empty() || b.empty())
+        {
+            return {};
+        }
+        if (std::min(a.size(), b.size()) < kKroneckerTerms)
+        {
+            std::vector<BigInteger> res(a.size() + b.size() - 1, BigInteger(0));
+            BigInteger t;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (a[i] == 0)
+                {
+                    continue;
+                }
+                for (size_t j = 0; j < b.size(); ++j)
+                {
+                    t = a[i];
+                    t *= b[j];
+                    res[i + j] += t;
+                }
+            }
+            return res;
+        }
+        // |c| <= min(n, m) * max|a| * max|b| < 10^k / 2
+        size_t k = maxDigits(a) + maxDigits(b) + digitCount(std::min(a.size(), b.size())) + 1;
+        BigInteger product = pack(a, k);
+        product *= pack(b, k);
+        return unpack(product, k, a.size() + b.size() - 1);
+    }
+
+    // coefficients below x^k
+    Polynomial truncated(size_t k) const
+    {
+        Polynomial res;
+        res.coefficients_.assign(coefficients_.begin(), coefficients_.begin() + std::min(k, coefficients_.size()));
+        res.trim();
+        return res;
+    }
+
+    // x^n * p(1 / x) for n >= degree
+    Polynomial reversed(size_t n) const
+    {
+        Polynomial res;
+        res.coefficients_.assign(n + 1, T(0));
+        for (size_t i = 0; i < coefficients_.size(); ++i)
+        {
+            res.coefficients_[n - i] = coefficients_[i];
+        }
+        res.trim();
+        return res;
+    }
+
+    static bool isUnit(const T &x)
+    {
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            return x != 0;
+        }
+        else
+        {
+            return x == 1 || x == -1;
+        }
+    }
+
+    // 1 / *this mod x^k by Newton iteration g <- g (2 - f g), the constant term must be a unit
+    Polynomial inverseSeries(size_t k) const
+    {
+        Polynomial g{T(1) / coefficients_[0]};
+        for (size_t l = 1; l < k;)
+        {
+            l = std::min(2 * l, k);
+            Polynomial e = (truncated(l) * g).truncated(l);
+            e = -e;
+            if (e.coefficients_.empty())
+            {
+                e.coefficients_.push_back(T(0));
+            }
+            e.coefficients_[0] += 2;
+            e.trim();
+            g = (g * e).truncated(l);
+        }
+        return g;
+    }
+
+    // quotient and remainder by long division; over BigInteger every step must divide exactly
+    std::pair<Polynomial, Polynomial> longDivision(const Polynomial &d) const
+    {
+        size_t n = coefficients_.size(), m = d.coefficients_.size();
+        Polynomial q, r = *this;
+        q.coefficients_.assign(n - m + 1, T(0));
+        const T &lead = d.coefficients_.back();
+        T t(0);
+        for (size_t i = n - m + 1; i-- > 0;)
+        {
+            T &top = r.coefficients_[i + m - 1];
+            if (top == 0)
+            {
+                continue;
+            }
+            T c = top;
+            if (lead != 1)
+            {
+                if constexpr (std::is_same<T, BigInteger>::value)
+                {
+                    if (c % lead != 0)
+                    {
+                        throw std::domain_error("Polynomial: division is not exact over the integers");
+                    }
+                }
+                c /= lead;
+            }
+            for (size_t j = 0; j < m; ++j)
+            {
+                t = c;
+                t *= d.coefficients_[j];
+                r.coefficients_[i + j] -= t;
+            }
+            q.coefficients_[i] = c;
+        }
+        q.trim();
+        r.trim();
+        return {q, r};
+    }
+
+    // the Newton division: rev(q) = rev(a) / rev(d) mod x^(n - m + 1)
+    std::pair<Polynomial, Polynomial> newtonDivision(const Polynomial &d) const
+    {
+        size_t n = coefficients_.size() - 1, m = d.coefficients_.size() - 1, k = n - m + 1;
+        Polynomial inv = d.reversed(m).inverseSeries(k);
+        Polynomial q = (reversed(n).truncated(k) * inv).truncated(k).reversed(k - 1);
+        Polynomial r = *this - q * d;
+        return {q, r};
+    }
+
+public:
+    Polynomial() = default;
+
+    Polynomial(std::vector<T> coefficients) : coefficients_(std::move(coefficients))
+    {
+        trim();
+    }
+
+    Polynomial(std::initializer_list<T> coefficients) : coefficients_(coefficients)
+    {
+        trim();
+    }
+
+    // -1 for the zero polynomial
+    int64_t degree() const
+    {
+        return static_cast<int64_t>(coefficients_.size()) - 1;
+    }
+
+    const std::vector<T> &getCoefficients() const
+    {
+        return coefficients_;
+    }
+
+    T operator[](size_t i) const
+    {
+        return i < coefficients_.size() ? coefficients_[i] : T(0);
+    }
+
+    bool operator==(const Polynomial &x) const
+    {
+        return coefficients_ == x.coefficients_;
+    }
+
+    bool operator!=(const Polynomial &x) const
+    {
+        return !(*this == x);
+    }
+
+    Polynomial operator-() const
+    {
+        Polynomial res = *this;
+        for (T &c : res.coefficients_)
+        {
+            c = -c;
+        }
+        return res;
+    }
+
+    Polynomial &operator+=(const Polynomial &x)
+    {
+        if (coefficients_.size() < x.coefficients_.size())
+        {
+            coefficients_.resize(x.coefficients_.size(), T(0));
+        }
+        for (size_t i = 0; i < x.coefficients_.size(); ++i)
+        {
+            coefficients_[i] += x.coefficients_[i];
+        }
+        trim();
+        return *this;
+    }
+
+    Polynomial &operator-=(const Polynomial &x)
+    {
+        if (coefficients_.size() < x.coefficients_.size())
+        {
+            coefficients_.resize(x.coefficients_.size(), T(0));
+        }
+        for (size_t i = 0; i < x.coefficients_.size(); ++i)
+        {
+            coefficients_[i] -= x.coefficients_[i];
+        }
+        trim();
+        return *this;
+    }
+
+    Polynomial &operator*=(const Polynomial &x)
+    {
+        std::vector<BigInteger> a, b;
+        BigInteger scale = toIntegers(coefficients_, a);
+        scale *= toIntegers(x.coefficients_, b);
+        std::vector<BigInteger> product = multiplyIntegers(a, b);
+        coefficients_ = fromIntegers(product, scale);
+        trim();
+        return *this;
+    }
+
+    friend Polynomial operator+(Polynomial a, const Polynomial &b)
+    {
+        return a += b;
+    }
+
+    friend Polynomial operator-(Polynomial a, const Polynomial &b)
+    {
+        return a -= b;
+    }
+
+    friend Polynomial operator*(Polynomial a, const Polynomial &b)
+    {
+        return a *= b;
+    }
+
+    // Quotient and remainder with deg(remainder) < deg(d). Over BigInteger the division has to
+    // be exact at every step (e.g. a monic divisor), otherwise std::domain_error is thrown.
+    std::pair<Polynomial, Polynomial> divmod(const Polynomial &d) const
+    {
+        if (d.coefficients_.empty())
+        {
+            throw std::domain_error("Polynomial: division by zero");
+        }
+        if (coefficients_.size() < d.coefficients_.size())
+        {
+            return {Polynomial(), *this};
+        }
+        size_t k = coefficients_.size() - d.coefficients_.size() + 1;
+        if (k >= kNewtonTerms && d.coefficients_.size() > 1 && isUnit(d.coefficients_.back()))
+        {
+            return newtonDivision(d);
+        }
+        return longDivision(d);
+    }
+
+    // *this / d for a divisor that divides *this, std::domain_error otherwise
+    Polynomial divideExact(const Polynomial &d) const
+    {
+        std::pair<Polynomial, Polynomial> qr = divmod(d);
+        if (!qr.second.coefficients_.empty())
+        {
+            throw std::domain_error("Polynomial: division is not exact");
+        }
+        return qr.first;
+    }
+
+    // Horner's rule; a Rational point runs on integers only (see evaluate)
+    T operator()(const T &x) const
+    {
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            return evaluate(std::vector<Rational>{x})[0];
+        }
+        else
+        {
+            T res(0);
+            for (size_t i = coefficients_.size(); i > 0; --i)
+            {
+                res *= x;
+                res += coefficients_[i - 1];
+            }
+            return res;
+        }
+    }
+
+    // Values at all points. Over Rational the coefficient denominators are cleared once for
+    // all points, and each p(a / b) is found as sum c_i a^i b^(n - i) / (scale * b^n) with
+    // integer Horner steps, so only the final value pays for a gcd.
+    std::vector<T> evaluate(const std::vector<T> &points) const
+    {
+        std::vector<T> res;
+        res.reserve(points.size());
+        if (coefficients_.empty())
+        {
+            res.assign(points.size(), T(0));
+            return res;
+        }
+        if constexpr (std::is_same<T, Rational>::value)
+        {
+            std::vector<BigInteger> c;
+            BigInteger scale = toIntegers(coefficients_, c);
+            for (const Rational &x : points)
+            {
+                BigInteger a = x.numerator(), b = x.denominator();
+                BigInteger acc = c.back(), power = 1, t;
+                for (size_t i = c.size() - 1; i > 0; --i)
+                {
+                    acc *= a;
+                    if (b != 1)
+                    {
+                        power *= b;
+                        t = c[i - 1];
+                        t *= power;
+                        acc += t;
+                    }
+                    else
+                    {
+                        acc += c[i - 1];
+                    }
+                }
+                power *= scale;
+                res.push_back(Rational(acc, power));
+            }
+        }
+        else
+        {
+            for (const BigInteger &x : points)
+            {
+                res.push_back((*this)(x));
+            }
+        }
+        return res;
+    }
+};
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "biginteger.h"
+#include <stdexcept>
+
+// A set of word-sized primes p_i (just below 2^31) whose product M bounds the values an
+// RnsInteger can hold: every |value| < M / 2 is represented exactly by its residues.
+class RnsBasis
+{
+private:
+    std::vector<uint32_t> primes_;
+    std::vector<uint32_t> inverses_;            // (M / p_i)^-1 mod p_i
+    std::vector<std::vector<BigInteger>> tree_; // product tree, tree_[0] holds the primes
+    BigInteger half_;
+
+    static uint32_t powMod(uint64_t a, uint64_t e, uint32_t p)
+    {
+        uint64_t res = 1;
+        a %= p;
+        while (e != 0)
+        {
+            if (e & 1)
+            {
+                res = res * a % p;
+            }
+            a = a * a % p;
+            e >>= 1;
+        }
+        return res;
+    }
+
+    // deterministic Miller-Rabin for 32-bit numbers
+    static bool isPrime(uint32_t n)
+    {
+        if (n < 2 || n % 2 == 0)
+        {
+            return n == 2;
+        }
+        uint32_t d = n - 1;
+        size_t s = 0;
+        while (d % 2 == 0)
+        {
+            d /= 2;
+            ++s;
+        }
+        for (uint32_t a : {2u, 7u, 61u})
+        {
+            if (a % n == 0)
+            {
+                continue;
+            }
+            uint64_t x = powMod(a, d, n);
+            if (x == 1 || x == n - 1)
+            {
+                continue;
+            }
+            bool composite = true;
+            for (size_t i = 1; i < s && composite; ++i)
+            {
+                x = x * x % n;
+                composite = (x != n - 1);
+            }
+            if (composite)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    // Picks enough primes to hold any value with at most `digits` decimal digits
+    explicit RnsBasis(size_t digits)
+    {
+        // every prime exceeds 10^9, so 9 * k >= digits + 1 gives M > 2 * 10^digits
+        size_t count = digits / 9 + 1;
+        for (uint32_t candidate = (1u << 31) - 1; primes_.size() < count; candidate -= 2)
+        {
+            if (isPrime(candidate))
+            {
+                primes_.push_back(candidate);
+            }
+        }
+
+        inverses_.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t prod = 1;
+            for (size_t j = 0; j < count; ++j)
+            {
+                if (j != i)
+                {
+                    prod = prod * primes_[j] % primes_[i];
+                }
+            }
+            inverses_[i] = powMod(prod, primes_[i] - 2, primes_[i]);
+        }
+
+        tree_.emplace_back();
+        for (uint32_t p : primes_)
+        {
+            tree_[0].push_back(BigInteger(static_cast<int64_t>(p)));
+        }
+        while (tree_.back().size() > 1)
+        {
+            const std::vector<BigInteger> &prev = tree_.back();
+            std::vector<BigInteger> level;
+            for (size_t i = 0; i + 1 < prev.size(); i += 2)
+            {
+                level.push_back(prev[i] * prev[i + 1]);
+            }
+            if (prev.size() % 2 == 1)
+            {
+                level.push_back(prev.back());
+            }
+            tree_.push_back(std::move(level));
+        }
+        half_ = modulus() / 2;
+    }
+
+    size_t size() const
+    {
+        return primes_.size();
+    }
+
+    uint32_t prime(size_t i) const
+    {
+        return primes_[i];
+    }
+
+    const BigInteger &modulus() const
+    {
+        return tree_.back()[0];
+    }
+
+    std::vector<uint32_t> residues(const BigInteger &x) const
+    {
+        // regroup the decimal digits into base 10^9 limbs once, then reduce every channel
+        const BigIntegerDigits &digits = x.getDigits();
+        std::vector<uint32_t> limbs((digits.size() + 8) / 9, 0);
+        for (size_t i = digits.size(); i > 0; --i)
+        {
+            limbs[(i - 1) / 9] = limbs[(i - 1) / 9] * 10 + digits[i - 1];
+        }
+        std::vector<uint32_t> res(primes_.size());
+        for (size_t i = 0; i < primes_.size(); ++i)
+        {
+            uint64_t p = primes_[i], r = 0;
+            for (size_t j = limbs.size(); j > 0; --j)
+            {
+                r = (r * 1000000000 + limbs[j - 1]) % p;
+            }
+            res[i] = (x.getSign() || r == 0) ? r : p - r;
+        }
+        return res;
+    }
+
+    std::vector<uint32_t> residues(int64_t x) const
+    {
+        std::vector<uint32_t> res(primes_.size());
+        for (size_t i = 0; i < primes_.size(); ++i)
+        {
+            int64_t r = x % static_cast<int64_t>(primes_[i]);
+            res[i] = (r < 0) ? r + primes_[i] : r;
+        }
+        return res;
+    }
+
+    // CRT: x = sum c_i * M / p_i with c_i = r_i * inverses_[i], summed bottom-up over the
+    // product tree, so that every multiplication pairs operands of similar size
+    BigInteger reconstruct(const std::vector<uint32_t> &res) const
+    {
+        std::vector<BigInteger> values(primes_.size());
+        for (size_t i = 0; i < primes_.size(); ++i)
+        {
+            values[i] = BigInteger(static_cast<int64_t>(static_cast<uint64_t>(res[i]) * inverses_[i] % primes_[i]));
+        }
+        for (size_t level = 0; level + 1 < tree_.size(); ++level)
+        {
+            const std::vector<BigInteger> &prods = tree_[level];
+            std::vector<BigInteger> next;
+            for (size_t i = 0; i + 1 < values.size(); i += 2)
+            {
+                next.push_back(values[i] * prods[i + 1] + values[i + 1] * prods[i]);
+            }
+            if (values.size() % 2 == 1)
+            {
+                next.push_back(values.back());
+            }
+            values.swap(next);
+        }
+        BigInteger x = values[0] % modulus();
+        if (x > half_)
+        {
+            x -= modulus();
+        }
+        return x;
+    }
+};
+
+// Integer stored as residues modulo the primes of an RnsBasis. Addition, subtraction and
+// multiplication work channel by channel with no carries between channels, so the loops
+// vectorize and can be split across threads; the result is exact as long as it stays
+// below the bound the basis was built for. Operands must share the same basis object;
+// mixing bases throws std::invalid_argument.
+class RnsInteger
+{
+private:
+    std::shared_ptr<const RnsBasis> basis_;
+    std::vector<uint32_t> residues_;
+
+    void checkBasis(const RnsInteger &x) const
+    {
+        if (basis_ != x.basis_)
+        {
+            throw std::invalid_argument("RnsInteger: operands have different bases");
+        }
+    }
+
+public:
+    RnsInteger(std::shared_ptr<const RnsBasis> basis, const BigInteger &x)
+        : basis_(std::move(basis))
+    {
+        residues_ = basis_->residues(x);
+    }
+
+    RnsInteger(std::shared_ptr<const RnsBasis> basis, int64_t x = 0)
+        : basis_(std::move(basis))
+    {
+        residues_ = basis_->residues(x);
+    }
+
+    const std::shared_ptr<const RnsBasis> &basis() const
+    {
+        return basis_;
+    }
+
+    uint32_t residue(size_t i) const
+    {
+        return residues_[i];
+    }
+
+    BigInteger toBigInteger() const
+    {
+        return basis_->reconstruct(residues_);
+    }
+
+    RnsInteger operator-() const
+    {
+        RnsInteger res = *this;
+        for (size_t i = 0; i < residues_.size(); ++i)
+        {
+            res.residues_[i] = (residues_[i] == 0) ? 0 : basis_->prime(i) - residues_[i];
+        }
+        return res;
+    }
+
+    RnsInteger &operator+=(const RnsInteger &x)
+    {
+        checkBasis(x);
+        for (size_t i = 0; i < residues_.size(); ++i)
+        {
+            uint32_t p = basis_->prime(i);
+            uint32_t r = residues_[i] + x.residues_[i]; // p < 2^31, no overflow
+            residues_[i] = (r >= p) ? r - p : r;
+        }
+        return *this;
+    }
+
+    RnsInteger &operator-=(const RnsInteger &x)
+    {
+        checkBasis(x);
+        for (size_t i = 0; i < residues_.size(); ++i)
+        {
+            uint32_t p = basis_->prime(i);
+            uint32_t r = residues_[i] + p - x.residues_[i];
+            residues_[i] = (r >= p) ? r - p : r;
+        }
+        return *this;
+    }
+
+    RnsInteger &operator*=(const RnsInteger &x)
+    {
+        checkBasis(x);
+        for (size_t i = 0; i < residues_.size(); ++i)
+        {
+            residues_[i] = static_cast<uint64_t>(residues_[i]) * x.residues_[i] % basis_->prime(i);
+        }
+        return *this;
+    }
+
+    friend RnsInteger operator+(const RnsInteger &x, const RnsInteger &y)
+    {
+        RnsInteger cpy = x;
+        cpy += y;
+        return cpy;
+    }
+
+    friend RnsInteger operator-(const RnsInteger &x, const RnsInteger &y)
+    {
+        RnsInteger cpy = x;
+        cpy -= y;
+        return cpy;
+    }
+
+    friend RnsInteger operator*(const RnsInteger &x, const RnsInteger &y)
+    {
+        RnsInteger cpy = x;
+        cpy *= y;
+        return cpy;
+    }
+
+    bool operator==(const RnsInteger &x) const
+    {
+        return basis_ == x.basis_ && residues_ == x.residues_;
+    }
+
+    bool operator!=(const RnsInteger &x) const
+    {
+        return !(*this == x);
+    }
+};
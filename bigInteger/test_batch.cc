@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "batch.h"
+#include <string>
+#include <vector>
+
+TEST(Batch, OrderedResultsAndSharing)
+{
+    Batch<BigInteger> batch;
+    BigInteger big("123456789012345678901234567890");
+    auto x = batch.constant(big), two = batch.constant(2), three = batch.constant(3);
+    auto square = batch.multiply(x, x);
+    ASSERT_EQ(batch.add(two, three), batch.add(three, two));
+    ASSERT_EQ(batch.multiply(x, x), square);
+    ASSERT_NE(batch.subtract(two, three), batch.subtract(three, two));
+    ASSERT_EQ(batch.constant(BigInteger("123456789012345678901234567890")), x);
+    size_t nodes = batch.nodeCount();
+
+    batch.submit(batch.add(square, two));
+    batch.submit(batch.negate(batch.subtract(square, three)));
+    batch.submit(batch.divide(square, batch.constant(big)));
+    batch.submit(square);
+    ASSERT_EQ(batch.nodeCount(), nodes + 4);
+    for (size_t threads : {1, 4})
+    {
+        std::vector<BigInteger> res = batch.evaluate(threads);
+        ASSERT_EQ(res.size(), 4);
+        ASSERT_EQ(res[0], big * big + 2);
+        ASSERT_EQ(res[1], 3 - big * big);
+        ASSERT_EQ(res[2], big);
+        ASSERT_EQ(res[3], big * big);
+    }
+}
+
+TEST(Batch, ParallelMatchesSerial)
+{
+    // harmonic partial sums H_1..H_200 share every prefix, so the DAG is a long chain
+    // with many roots hanging off it, plus independent products per root
+    Batch<Rational> batch;
+    auto sum = batch.constant(0);
+    for (int i = 1; i <= 200; ++i)
+    {
+        sum = batch.add(sum, batch.constant(Rational(1, i)));
+        batch.submit(sum);
+        batch.submit(batch.multiply(sum, batch.constant(Rational(i, i + 1))));
+    }
+    std::vector<Rational> serial = batch.evaluate(1), parallel = batch.evaluate(8);
+    ASSERT_EQ(serial.size(), 400);
+    ASSERT_EQ(serial, parallel);
+    Rational h = 0;
+    for (int i = 1; i <= 200; ++i)
+    {
+        h += Rational(1, i);
+        ASSERT_EQ(serial[2 * i - 2], h);
+        ASSERT_EQ(serial[2 * i - 1], h * Rational(i, i + 1));
+    }
+}
+
+TEST(Batch, Errors)
+{
+    Batch<Rational> batch;
+    auto one = batch.constant(1), zero = batch.subtract(one, one);
+    batch.submit(batch.add(one, one));
+    batch.submit(batch.divide(one, zero));
+    ASSERT_THROW(batch.evaluate(1), std::domain_error);
+    ASSERT_THROW(batch.evaluate(3), std::domain_error);
+    ASSERT_THROW(batch.add(one, 42), std::out_of_range);
+    batch.clear();
+    ASSERT_EQ(batch.size(), 0);
+    ASSERT_TRUE(batch.evaluate().empty());
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "bigdecimal.h"
+#include <sstream>
+#include <string>
+
+TEST(BigDecimal, ParseAndPrint)
+{
+    ASSERT_EQ(BigDecimal("123.4500").toString(), "123.4500");
+    ASSERT_EQ(BigDecimal("-0.05").toString(), "-0.05");
+    ASSERT_EQ(BigDecimal("+7").toString(), "7");
+    ASSERT_EQ(BigDecimal("1.5e3").toString(), "1500");
+    ASSERT_EQ(BigDecimal("1.5e-3").toString(), "0.0015");
+    ASSERT_EQ(BigDecimal("-.5").toString(), "-0.5");
+    ASSERT_EQ(BigDecimal("1.5e3").getScale(), -2);
+    ASSERT_EQ(BigDecimal(BigInteger(-12345), 7).toString(), "-0.0012345");
+    ASSERT_THROW(BigDecimal("1.2.3"), std::invalid_argument);
+    ASSERT_THROW(BigDecimal("e5"), std::invalid_argument);
+    ASSERT_THROW(BigDecimal("1e"), std::invalid_argument);
+    std::stringstream ss("3.14 -2.5e1");
+    BigDecimal a, b;
+    ss >> a >> b;
+    ss.clear();
+    ss.str("");
+    ss << a << " " << b;
+    ASSERT_EQ(ss.str(), "3.14 -25");
+}
+
+TEST(BigDecimal, ScientificNotation)
+{
+    ASSERT_EQ(BigDecimal("123.45").toScientificString(), "1.2345E+2");
+    ASSERT_EQ(BigDecimal("-0.00012").toScientificString(), "-1.2E-4");
+    ASSERT_EQ(BigDecimal("1.500e10").toScientificString(), "1.500E+10");
+    ASSERT_EQ(BigDecimal(7).toScientificString(), "7E+0");
+    ASSERT_EQ(BigDecimal("0.000").toScientificString(), "0E-3");
+    ASSERT_EQ(BigDecimal(BigInteger(0), -2).toScientificString(), "0E+2");
+    for (const char *s : {"123.45", "-0.00012", "1.500e10", "0.000", "-9e-30", "31415926535897932384626e-22"})
+    {
+        BigDecimal x(s), y(x.toScientificString());
+        ASSERT_EQ(y.getMantissa(), x.getMantissa());
+        ASSERT_EQ(y.getScale(), x.getScale());
+    }
+}
+
+TEST(BigDecimal, Arithmetic)
+{
+    BigDecimal price("19.99"), qty(3), rate("0.0825");
+    ASSERT_EQ((price * qty).toString(), "59.97");
+    ASSERT_EQ((price * qty * rate).toString(), "4.947525");
+    ASSERT_EQ((price * qty * rate).withScale(2).toString(), "4.95");
+    ASSERT_EQ((BigDecimal("0.1") + BigDecimal("0.2")).toString(), "0.3");
+    ASSERT_EQ((BigDecimal("1") - BigDecimal("0.001")).toString(), "0.999");
+    ASSERT_EQ((BigDecimal("-1.10") + BigDecimal("1.1")).toString(), "0.00");
+    ASSERT_TRUE(BigDecimal("1.0") == BigDecimal("1.000"));
+    ASSERT_TRUE(BigDecimal("-0.3") < BigDecimal("-0.25"));
+    ASSERT_EQ(BigDecimal("12.3400").stripTrailingZeros().toString(), "12.34");
+    ASSERT_EQ(BigDecimal("1.25").toRational().toString(), "5/4");
+}
+
+TEST(BigDecimal, RoundingModes)
+{
+    std::vector<std::string> values = {"5.5", "2.5", "1.6", "1.1", "1.0", "-1.0", "-1.1", "-1.6", "-2.5", "-5.5"};
+    std::vector<std::pair<RoundingMode, std::string>> expected = {
+        {RoundingMode::Up, "6 3 2 2 1 -1 -2 -2 -3 -6 "},
+        {RoundingMode::Down, "5 2 1 1 1 -1 -1 -1 -2 -5 "},
+        {RoundingMode::Ceiling, "6 3 2 2 1 -1 -1 -1 -2 -5 "},
+        {RoundingMode::Floor, "5 2 1 1 1 -1 -2 -2 -3 -6 "},
+        {RoundingMode::HalfUp, "6 3 2 1 1 -1 -1 -2 -3 -6 "},
+        {RoundingMode::HalfDown, "5 2 2 1 1 -1 -1 -2 -2 -5 "},
+        {RoundingMode::HalfEven, "6 2 2 1 1 -1 -1 -2 -2 -6 "},
+    };
+    for (auto &[mode, result] : expected)
+    {
+        std::string s;
+        for (const std::string &v : values)
+            s += BigDecimal(v).withScale(0, mode).toString() + " ";
+        ASSERT_EQ(s, result);
+    }
+    ASSERT_EQ(BigDecimal("0.004").withScale(2, RoundingMode::Up).toString(), "0.01");
+    ASSERT_EQ(BigDecimal("-0.004").withScale(2, RoundingMode::HalfEven).toString(), "0.00");
+}
+
+TEST(BigDecimal, Division)
+{
+    ASSERT_EQ(BigDecimal(1).divide(BigDecimal(3), 10).toString(), "0.3333333333");
+    ASSERT_EQ(BigDecimal(2).divide(BigDecimal(3), 10).toString(), "0.6666666667");
+    ASSERT_EQ(BigDecimal(-2).divide(BigDecimal(3), 3, RoundingMode::Floor).toString(), "-0.667");
+    ASSERT_EQ(BigDecimal("100").divide(BigDecimal("0.08"), 0).toString(), "1250");
+    ASSERT_EQ(BigDecimal("1e5").divide(BigDecimal(7), -2).toString(), "14300");
+    BigDecimal::setDivisionScale(4, RoundingMode::Down);
+    ASSERT_EQ((BigDecimal(10) / BigDecimal(7)).toString(), "1.4285");
+    BigDecimal::setDivisionScale(20);
+    ASSERT_EQ((BigDecimal(1) / BigDecimal(8)).toString(), "0.12500000000000000000");
+    ASSERT_EQ(BigDecimal(-1).divide(BigDecimal(2), 0).toString(), "0");
+    ASSERT_EQ(BigDecimal(-1).divide(BigDecimal(2), 0, RoundingMode::Down).toString(), "0");
+    ASSERT_EQ(BigDecimal(-1).divide(BigDecimal(2), 0, RoundingMode::Floor).toString(), "-1");
+    ASSERT_THROW(BigDecimal(1) / BigDecimal("0.00"), std::domain_error);
+}
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <type_traits>
 #include <sstream>
+#include <iomanip>
+#include <unordered_set>
 
 TEST(AssignementStreamTest, IntAndStream)
 {
@@ -245,6 +247,15 @@ TEST(BigNumbers, Division)
     // }
 }
 
+TEST(BigNumbers, DivisionRoundsTowardsZero)
+{
+    BigInteger a = -1, b = 2;
+    ASSERT_EQ((a / b).toString(), "0");
+    ASSERT_EQ((a / -b).toString(), "0");
+    ASSERT_EQ((a % b).toString(), "-1");
+    ASSERT_EQ((BigInteger(-3) / b).toString(), "-1");
+}
+
 TEST(BigNumbers, Modulo)
 {
     BigInteger a, b;
@@ -271,6 +282,139 @@ TEST(BigNumbers, Modulo)
     // }
 }
 
+TEST(MixedInt64, Arithmetic)
+{
+    BigInteger a("123456789012345678901234567890");
+    std::ostringstream oss;
+    oss << a + 10 << ' ' << 10 - a << ' ' << a * -3 << ' ' << a / 7 << ' ' << a % 7 << ' ' << -a % 7;
+    ASSERT_EQ(oss.str(), "123456789012345678901234567900 -123456789012345678901234567880 "
+                         "-370370367037037036703703703670 17636684144620811271604938270 0 0");
+    BigInteger b = 5;
+    b -= 12;
+    ASSERT_EQ(b.toString(), "-7");
+    b += 7;
+    ASSERT_EQ(b.toString(), "0");
+    ASSERT_EQ((100 / BigInteger(-7)).toString(), "-14");
+    ASSERT_EQ((-100 % BigInteger(7)).toString(), "-2");
+    ASSERT_EQ(BigInteger(INT64_MIN).toString(), "-9223372036854775808");
+    ASSERT_EQ((BigInteger(0) - INT64_MIN).toString(), "9223372036854775808");
+}
+
+TEST(MixedInt64, DivisionByZero)
+{
+    BigInteger a("123456789012345678901234567890"), zero = 0;
+    ASSERT_THROW(a / 0, std::domain_error);
+    ASSERT_THROW(a % 0, std::domain_error);
+    ASSERT_THROW(7 / zero, std::domain_error);
+    ASSERT_THROW(7 % zero, std::domain_error);
+    ASSERT_THROW(a / zero, std::domain_error);
+    ASSERT_THROW(a % zero, std::domain_error);
+    ASSERT_THROW(a /= 0, std::domain_error);
+    ASSERT_EQ(a.toString(), "123456789012345678901234567890");
+}
+
+TEST(MixedInt64, Comparison)
+{
+    BigInteger a = -42, b("100000000000000000000");
+    ASSERT_TRUE(a == -42);
+    ASSERT_TRUE(-42 == a);
+    ASSERT_TRUE(a < 0 && a > -43 && a <= -42 && a >= -42 && a != 42);
+    ASSERT_TRUE(b > INT64_MAX);
+    ASSERT_TRUE(INT64_MIN < a);
+    ASSERT_EQ(BigInteger(0).compare(0), 0);
+}
+
+TEST(Accumulator, SumAndMerge)
+{
+    BigInteger::Accumulator first, second;
+    BigInteger expected = 0;
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        BigInteger x = BigInteger("98765432109876543210") * (i - 500);
+        expected += x;
+        if (i % 2 == 0)
+        {
+            first += x;
+        }
+        else
+        {
+            second -= -x;
+        }
+    }
+    first.merge(second);
+    ASSERT_EQ(first.finish(), expected);
+    ASSERT_EQ(first.finish().toString(), "-49382716054938271605000");
+    ASSERT_EQ(BigInteger::Accumulator().finish().toString(), "0");
+}
+
+TEST(IOStreams, LargeAndMalformed)
+{
+    std::string digits(100000, '7');
+    std::istringstream iss("  -" + digits + "\n+0042 -0 x");
+    BigInteger a, b, c, d;
+    iss >> a >> b >> c;
+    ASSERT_TRUE(iss.good());
+    std::ostringstream oss;
+    oss << a << ' ' << b << ' ' << c;
+    ASSERT_EQ(oss.str(), "-" + digits + " 42 0");
+    iss >> d;
+    ASSERT_TRUE(iss.fail());
+    std::ostringstream padded;
+    padded << std::setw(5) << BigInteger(-12);
+    ASSERT_EQ(padded.str(), "  -12");
+}
+
+TEST(Radix, HexAndBinary)
+{
+    BigInteger a = BigInteger::fromString("-DeadBeefCafeBabe0123456789abcdef", 16);
+    ASSERT_EQ(a.toString(), "-295990755076957304698161171062762229231");
+    ASSERT_EQ(a.toString(16), "-deadbeefcafebabe0123456789abcdef");
+    ASSERT_EQ(BigInteger(1025).toString(2), "10000000001");
+    ASSERT_EQ(BigInteger::fromString("zz", 36), 1295);
+    ASSERT_EQ(BigInteger(0).toString(7), "0");
+    ASSERT_EQ(BigInteger::fromString("-0", 3).toString(), "0");
+    ASSERT_THROW(BigInteger::fromString("12", 2), std::invalid_argument);
+    ASSERT_THROW(BigInteger(5).toString(37), std::invalid_argument);
+}
+
+TEST(BigNumbers, LongMultiplication)
+{
+    // (10^n - 1)^2 = 10^2n - 2 * 10^n + 1 crosses the limb and Karatsuba thresholds
+    for (size_t n : {31, 32, 300, 2000})
+    {
+        BigInteger a(std::string(n, '9'));
+        std::string expected = std::string(n - 1, '9') + "8" + std::string(n - 1, '0') + "1";
+        ASSERT_EQ((a * a).toString(), expected);
+        ASSERT_EQ((a * -a).toString(), "-" + expected);
+    }
+    BigInteger x(std::string(5000, '7')), y(std::string(300, '3'));
+    ASSERT_EQ(x * y, y * x);
+    ASSERT_EQ((x * y) / y, x);
+    ASSERT_EQ((x * BigInteger(0)).toString(), "0");
+}
+
+TEST(MixedInt64, CompareAndHash)
+{
+    BigInteger a("123456789012345678901234567890"), b("-123456789012345678901234567890"), z = 0;
+    ASSERT_EQ(a.compare(b), 1);
+    ASSERT_EQ(b.compare(a), -1);
+    ASSERT_EQ(a.compare(a), 0);
+    ASSERT_EQ(z.compare(-z), 0);
+    ASSERT_TRUE(b <= a && a >= b && !(a <= b));
+    ASSERT_EQ(std::hash<BigInteger>()(a), std::hash<BigInteger>()(BigInteger("123456789012345678901234567890")));
+    ASSERT_NE(std::hash<BigInteger>()(a), std::hash<BigInteger>()(b));
+    ASSERT_EQ(std::hash<BigInteger>()(z), std::hash<BigInteger>()(-z));
+    std::unordered_set<BigInteger> seen;
+    for (int i = -500; i < 500; ++i)
+    {
+        seen.insert(BigInteger(i) * a);
+    }
+    seen.insert(BigInteger(7) * a);
+    ASSERT_EQ(seen.size(), 1000);
+    ASSERT_EQ(seen.count(a * 499), 1);
+    ASSERT_EQ(seen.count(a * 500), 0);
+}
+
 int main(int argc, char *argv[])
 {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,42 @@
+#include "gtest/gtest.h"
+#include "calculator.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+template <typename T>
+static std::string run(const std::vector<std::string_view> &lines, typename Calculator<T>::Syntax syntax,
+                       size_t threads = 1)
+{
+    std::string out;
+    Calculator<T>(syntax, threads).evaluate(lines, out);
+    return out;
+}
+
+TEST(Calculator, IntegerInfix)
+{
+    auto infix = Calculator<BigInteger>::Syntax::Infix;
+    ASSERT_EQ(run<BigInteger>({"1 + 2 * 3", "(1 - 5) / 2", "-2^2", "2^64 - 1", "", "-(-7)"}, infix),
+              "7\n-2\n-4\n18446744073709551615\n7\n");
+    ASSERT_EQ(run<BigInteger>({"1 +", "2 ^ x", "1.5", "7 / (3 - 3)", "3 3", "42"}, infix, 4),
+              "error: unexpected end of expression at column 4\n"
+              "error: exponent must be an integer literal at column 5\n"
+              "error: decimal literal in integer mode at column 2\n"
+              "error: Batch: division by zero\n"
+              "error: unexpected '3' at column 3\n"
+              "42\n");
+}
+
+TEST(Calculator, RationalAndRpn)
+{
+    auto infix = Calculator<Rational>::Syntax::Infix;
+    ASSERT_EQ(run<Rational>({"1/3 + 1/6", "1.25 * 4", "2^-3", "(2/3)^0", "0.1 + 0.2"}, infix, 2),
+              "1/2\n5\n1/8\n1\n3/10\n");
+    auto rpn = Calculator<Rational>::Syntax::Rpn;
+    ASSERT_EQ(run<Rational>({"1 2 + 3 *", "1 3 / 2 neg *", "1 +", "1 2", "2 x", "1.5 2 /"}, rpn),
+              "9\n-2/3\n"
+              "error: stack underflow at column 3\n"
+              "error: unused operands\n"
+              "error: unknown token 'x' at column 3\n"
+              "3/4\n");
+}
@@ -0,0 +1,46 @@
+#define BIGINTEGER_STATS
+#define BIGINTEGER_COW
+#include "gtest/gtest.h"
+#include "biginteger.h"
+#include <string>
+
+TEST(Cow, CopiesShareDigits)
+{
+    BigInteger a(std::string(1000, '7'));
+    BigIntegerStats::reset();
+    BigInteger b = a, c = -a, d = c.abs();
+    BigIntegerStats stats = BigIntegerStats::snapshot();
+    ASSERT_EQ(stats.allocations, 0);
+    ASSERT_EQ(a.getDigits().useCount(), 4);
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(d, a);
+    ASSERT_EQ(c.toString(), "-" + std::string(1000, '7'));
+}
+
+TEST(Cow, MutationUnshares)
+{
+    BigInteger a(std::string(100, '9'));
+    BigInteger b = a;
+    ++b;
+    ASSERT_EQ(a.toString(), std::string(100, '9'));
+    ASSERT_EQ(b.toString(), "1" + std::string(100, '0'));
+    ASSERT_EQ(a.getDigits().useCount(), 1);
+    BigInteger c = a;
+    c *= 10;
+    a -= c;
+    ASSERT_EQ(c.toString(), std::string(100, '9') + "0");
+    ASSERT_EQ(a.toString(), "-8" + std::string(99, '9') + "1");
+    BigInteger d = c;
+    d.dividePow10(1);
+    ASSERT_EQ(d.toString(), std::string(100, '9'));
+    ASSERT_EQ(c.toString(), std::string(100, '9') + "0");
+}
+
+TEST(Cow, RationalCopies)
+{
+    Rational x(BigInteger(std::string(30, '3')), BigInteger(std::string(25, '7')));
+    Rational y = x;
+    y += 1;
+    ASSERT_EQ(x, Rational(BigInteger(std::string(30, '3')), BigInteger(std::string(25, '7'))));
+    ASSERT_EQ(y - x, 1);
+}
@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "modint.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+static BigInteger mod(BigInteger x, const BigInteger &n)
+{
+    x %= n;
+    if (x < 0)
+        x += n;
+    return x;
+}
+
+TEST(ModInt, MatchesBigIntegerRemainder)
+{
+    BigInteger p("170141183460469231731687303715884105727"); // 2^127 - 1
+    for (const BigInteger &n : {p, BigInteger(1000), BigInteger("99999999999999999999999999999999999999999999")})
+    {
+        auto ctx = std::make_shared<const ModContext>(n);
+        BigInteger a("-123456789123456789123456789123456789123456789123456789"), b("98765432109876543210987654321");
+        ModInt x(ctx, a), y(ctx, b);
+        ASSERT_EQ(x.getValue(), mod(a, n));
+        ASSERT_EQ((x + y).getValue(), mod(a + b, n));
+        ASSERT_EQ((x - y).getValue(), mod(a - b, n));
+        ASSERT_EQ((y - x).getValue(), mod(b - a, n));
+        ASSERT_EQ((x * y).getValue(), mod(a * b, n));
+        ASSERT_EQ((-x).getValue(), mod(-a, n));
+        ModInt acc(ctx, 1);
+        for (int i = 0; i < 50; ++i)
+        {
+            acc *= y;
+            acc += x;
+        }
+        BigInteger ref = 1;
+        for (int i = 0; i < 50; ++i)
+            ref = mod(ref * b + a, n);
+        ASSERT_EQ(acc.getValue(), ref);
+    }
+}
+
+TEST(ModInt, InverseAndPow)
+{
+    BigInteger p("170141183460469231731687303715884105727");
+    auto ctx = std::make_shared<const ModContext>(p);
+    ModInt x(ctx, BigInteger("31415926535897932384626433832795028841971"));
+    ASSERT_EQ((x * x.inverse()).getValue(), 1);
+    ASSERT_EQ((x / x).getValue(), 1);
+    ASSERT_EQ(x.pow(p - 1).getValue(), 1); // Fermat
+    ASSERT_EQ(x.pow(0).getValue(), 1);
+    ASSERT_EQ(ModInt(ctx, 3).pow(100).getValue(), mod(BigInteger("515377520732011331036461129765621272702107522001"), p));
+    ASSERT_THROW(ModInt(ctx, 0).inverse(), std::domain_error);
+
+    auto composite = std::make_shared<const ModContext>(BigInteger(1000));
+    ASSERT_EQ(ModInt(composite, 7).inverse().getValue(), 143);
+    ASSERT_THROW(ModInt(composite, 10).inverse(), std::domain_error);
+    ASSERT_THROW(ModInt(composite, 1) + x, std::invalid_argument);
+    ASSERT_THROW(ModContext(BigInteger(1)), std::invalid_argument);
+}
+
+TEST(ModInt, BatchInverse)
+{
+    auto ctx = std::make_shared<const ModContext>(BigInteger("1000000000000000000000000000057"));
+    std::vector<ModInt> xs;
+    for (int i = 1; i <= 100; ++i)
+        xs.emplace_back(ctx, BigInteger(i) * BigInteger("123456789123456789"));
+    std::vector<ModInt> inv = ModInt::batchInverse(xs);
+    ASSERT_EQ(inv.size(), xs.size());
+    for (size_t i = 0; i < xs.size(); ++i)
+        ASSERT_EQ(inv[i], xs[i].inverse());
+    ASSERT_TRUE(ModInt::batchInverse({}).empty());
+
+    auto composite = std::make_shared<const ModContext>(BigInteger(1000));
+    std::vector<ModInt> bad = {ModInt(composite, 3), ModInt(composite, 4), ModInt(composite, 7)};
+    ASSERT_THROW(ModInt::batchInverse(bad), std::domain_error);
+}
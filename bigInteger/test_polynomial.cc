@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "polynomial.h"
+#include <string>
+#include <vector>
+
+static std::string str(const Polynomial<BigInteger> &p)
+{
+    std::string s;
+    for (const BigInteger &c : p.getCoefficients())
+        s += c.toString() + " ";
+    return s;
+}
+
+static std::string str(const Polynomial<Rational> &p)
+{
+    std::string s;
+    for (Rational c : p.getCoefficients())
+        s += c.toString() + " ";
+    return s;
+}
+
+TEST(Polynomial, Arithmetic)
+{
+    Polynomial<BigInteger> a = {1, 2, 3}, b = {-1, 0, 0, 1};
+    ASSERT_EQ(str(a + b), "0 2 3 1 ");
+    ASSERT_EQ(str(a - a), "");
+    ASSERT_EQ((a - a).degree(), -1);
+    ASSERT_EQ(str(a * b), "-1 -2 -3 1 2 3 ");
+    ASSERT_EQ(str(-b), "1 0 0 -1 ");
+    ASSERT_EQ(a(BigInteger(10)), 321);
+    ASSERT_EQ(b[7], 0);
+    Polynomial<Rational> r = {Rational(1, 2), Rational(-1, 3)};
+    ASSERT_EQ(str(r * r), "1/4 -1/3 1/9 ");
+    ASSERT_EQ(r(Rational(3, 2)).toString(), "0");
+}
+
+TEST(Polynomial, KroneckerMatchesSchoolbook)
+{
+    // (x - 1)(x^63 + ... + 1) = x^64 - 1, with negative and multi-digit coefficients mixed in
+    std::vector<BigInteger> ones(64, BigInteger(1));
+    Polynomial<BigInteger> geometric(ones), linear = {-1, 1};
+    std::vector<BigInteger> top(65, BigInteger(0));
+    top[64] = 1;
+    top[0] = -1;
+    ASSERT_EQ(geometric * linear, Polynomial<BigInteger>(top));
+
+    std::vector<BigInteger> a, b;
+    for (int64_t i = 0; i < 40; ++i)
+    {
+        a.push_back(BigInteger((i % 3 == 0 ? -1 : 1) * (i * 1000003 + 7)));
+        b.push_back(BigInteger(std::string(30, char('1' + i % 9))) * (i % 2 ? -1 : 1));
+    }
+    std::vector<BigInteger> naive(a.size() + b.size() - 1, BigInteger(0));
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j)
+            naive[i + j] += a[i] * b[j];
+    ASSERT_EQ(Polynomial<BigInteger>(a) * Polynomial<BigInteger>(b), Polynomial<BigInteger>(naive));
+}
+
+TEST(Polynomial, Division)
+{
+    Polynomial<BigInteger> a = {-4, 0, -2, 1}, d = {-3, 1};
+    auto qr = a.divmod(d);
+    ASSERT_EQ(str(qr.first), "3 1 1 ");
+    ASSERT_EQ(str(qr.second), "5 ");
+    ASSERT_EQ(str((a * d).divideExact(d)), str(a));
+    ASSERT_THROW(a.divideExact(d), std::domain_error);
+    ASSERT_THROW(a.divmod(Polynomial<BigInteger>{1, 2}), std::domain_error); // 2 does not divide 1
+    ASSERT_THROW(a.divmod(Polynomial<BigInteger>()), std::domain_error);
+
+    // long quotients go through the Newton inverse
+    std::vector<BigInteger> c;
+    for (int64_t i = 0; i < 100; ++i)
+        c.push_back(BigInteger(i * i - 50 * i + 3));
+    Polynomial<BigInteger> big(c), monic = {7, -2, 0, 5, 1};
+    auto bqr = big.divmod(monic);
+    ASSERT_EQ(bqr.first * monic + bqr.second, big);
+    ASSERT_LT(bqr.second.degree(), monic.degree());
+
+    Polynomial<Rational> r = {1, 0, 1}, s = {Rational(1, 2), 2};
+    auto rqr = r.divmod(s);
+    ASSERT_EQ(str(rqr.first), "-1/8 1/2 ");
+    ASSERT_EQ(str(rqr.second), "17/16 ");
+}
+
+TEST(Polynomial, MultipointEvaluation)
+{
+    Polynomial<BigInteger> p = {5, -3, 0, 2};
+    std::vector<BigInteger> points = {BigInteger(-2), BigInteger(0), BigInteger(3), BigInteger("100000000000")};
+    std::vector<BigInteger> values = p.evaluate(points);
+    ASSERT_EQ(values[0], -5);
+    ASSERT_EQ(values[1], 5);
+    ASSERT_EQ(values[2], 50);
+    ASSERT_EQ(values[3], BigInteger("1999999999999999999999700000000005"));
+
+    Polynomial<Rational> q = {Rational(1, 3), Rational(-1, 2), 1};
+    std::vector<Rational> rv = q.evaluate({Rational(1, 2), Rational(-2, 3), Rational(0), Rational(5)});
+    ASSERT_EQ(rv[0].toString(), "1/3");
+    ASSERT_EQ(rv[1].toString(), "10/9");
+    ASSERT_EQ(rv[2].toString(), "1/3");
+    ASSERT_EQ(rv[3].toString(), "137/6");
+    ASSERT_EQ(Polynomial<Rational>().evaluate({Rational(1)})[0], 0);
+}
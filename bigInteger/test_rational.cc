@@ -5,6 +5,9 @@
 #include <iostream>
 #include <type_traits>
 #include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 TEST(Arithmetic, AssignmentSmall)
 {
@@ -85,3 +88,195 @@ TEST(AsDecimal, NearZero) {
     // if ((t / s).asDecimal(25) != "-0.0000000000000000001873662")
     //     throw std::runtime_error("Test 8 failed.");
 }
+
+TEST(AsDecimal, NegativeRoundsToZero) {
+    ASSERT_EQ(Rational(-1, 2).asDecimal(0), "0");
+}
+
+TEST(MixedInt64, Arithmetic) {
+    Rational r = Rational(85) / 37;
+    ASSERT_EQ(r.toString(), "85/37");
+    r *= 74;
+    ASSERT_EQ(r.toString(), "170");
+    r /= -4;
+    ASSERT_EQ(r.toString(), "-85/2");
+    r += 43;
+    ASSERT_EQ(r.toString(), "1/2");
+    ASSERT_EQ((1 - r).toString(), "1/2");
+    ASSERT_EQ((3 / r).toString(), "6");
+    ASSERT_TRUE(r < 1 && r > 0 && 1 > r && r != 0);
+}
+
+TEST(AsDecimal, DigitGenerator) {
+    Rational r(-22, 7);
+    Rational::DecimalDigits digits = r.decimalDigits();
+    std::string s;
+    for (int i = 0; i < 14; ++i)
+        s.push_back('0' + digits.next());
+    ASSERT_EQ(s, "14285714285714");
+    ASSERT_EQ(digits.preperiod(), 0);
+    ASSERT_EQ(digits.period(), 6);
+
+    Rational t(1, 12); // 0.08(3)
+    Rational::DecimalDigits tail = t.decimalDigits();
+    for (int i = 0; i < 4; ++i)
+        tail.next();
+    ASSERT_EQ(tail.preperiod(), 2);
+    ASSERT_EQ(tail.period(), 1);
+
+    Rational::DecimalDigits finite = Rational(3, 8).decimalDigits();
+    ASSERT_EQ(finite.next() * 100 + finite.next() * 10 + finite.next(), 375);
+    ASSERT_TRUE(finite.done());
+    ASSERT_EQ(Rational(3, 8).asDecimal(5), "0.37500");
+    ASSERT_EQ(Rational(-1, 3).asDecimal(200).size(), 203);
+}
+
+TEST(LazyNormalization, Accumulation) {
+    Rational::setLazyThreshold(200);
+    Rational sum = 0, eager, small = 0;
+    BigInteger scale("100000000000000000000"); // keeps the values out of the word-sized path
+    for (int64_t i = 1; i <= 20; ++i)
+    {
+        sum += Rational(BigInteger(1), BigInteger(i * (i + 1)) * scale); // telescopes to 20/21 / scale
+        small += Rational(1, i * (i + 1));
+    }
+    ASSERT_FALSE(sum.isReduced());
+    ASSERT_TRUE(small.isReduced()); // word-sized gcds are cheap enough to always run
+    ASSERT_EQ(sum, Rational(BigInteger(20), BigInteger(21) * scale));
+    ASSERT_TRUE(sum < 1 && sum > 0);
+    Rational prod = sum * Rational(BigInteger(-21) * scale, BigInteger(10));
+    ASSERT_EQ(prod, -2);
+    ASSERT_EQ(prod.toString(), "-2");
+    ASSERT_TRUE(prod.isReduced());
+
+    Rational::setLazyThreshold(5); // large operands are reduced immediately
+    Rational big(BigInteger("1234567"), BigInteger("7654321"));
+    big *= Rational(2, 3);
+    ASSERT_TRUE(big.isReduced());
+    Rational::setLazyThreshold(0);
+    eager = Rational(1, 2) + Rational(1, 2);
+    ASSERT_TRUE(eager.isReduced());
+    ASSERT_EQ(eager.toString(), "1");
+}
+
+TEST(Arithmetic, ReducedAlgorithms) {
+    Rational a(7, 12), b(5, 18);
+    ASSERT_EQ((a + b).toString(), "31/36");
+    ASSERT_EQ((a - b).toString(), "11/36");
+    ASSERT_EQ((a * b).toString(), "35/216");
+    ASSERT_EQ((a / b).toString(), "21/10");
+    ASSERT_EQ((a / Rational(-7, 3)).toString(), "-1/4");
+    ASSERT_EQ((Rational(1, 6) + Rational(-1, 6)).toString(), "0");
+    ASSERT_EQ((Rational(1, 6) + Rational(1, 3)).toString(), "1/2");
+    Rational c = a;
+    c += c;
+    ASSERT_EQ(c.toString(), "7/6");
+    c *= c;
+    ASSERT_EQ(c.toString(), "49/36");
+    c /= c;
+    ASSERT_EQ(c.toString(), "1");
+}
+
+TEST(Relations, ThreeWayCompare) {
+    std::vector<Rational> v = {Rational(-1, 2), Rational(-3, 4), Rational(1, 3), Rational(-77),
+                               Rational(0), Rational(22, 7), Rational(BigInteger("100000000000000000000"), 3)};
+    std::sort(v.begin(), v.end());
+    std::string s;
+    for (Rational &r : v)
+        s += r.toString() + " ";
+    ASSERT_EQ(s, "-77 -3/4 -1/2 0 1/3 22/7 100000000000000000000/3 ");
+    ASSERT_EQ(Rational(-449, 912).compare(Rational(-77)), 1);
+    ASSERT_EQ(Rational(2, 6).compare(Rational(1, 3)), 0);
+    ASSERT_TRUE(Rational(1, 3) <= Rational(1, 3) && Rational(1, 3) >= Rational(2, 6));
+    ASSERT_TRUE(Rational(-1, 3) != Rational(1, 3));
+}
+
+TEST(Relations, Hash) {
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    std::hash<Rational> h;
+    ASSERT_EQ(h(Rational(2, 6)), h(Rational(-1, -3)));
+    ASSERT_NE(h(Rational(1, 3)), h(Rational(-1, 3)));
+    ASSERT_NE(h(Rational(1, 3)), h(Rational(3)));
+    // the same value reached through the promoted path hashes like the word-sized one
+    Rational big = Rational(max) + 1, back = big - 2;
+    ASSERT_EQ(h(back), h(Rational(max - 1)));
+    ASSERT_EQ(h(Rational(BigInteger("200000000000000000000"), BigInteger("600000000000000000000"))), h(Rational(1, 3)));
+    std::unordered_map<Rational, int> memo;
+    for (int i = 1; i <= 100; ++i)
+        memo[Rational(1, i) + Rational(1, i + 1)] = i;
+    ASSERT_EQ(memo.size(), 100);
+    ASSERT_EQ(memo[Rational(3, 2)], 1);
+}
+
+TEST(Conversion, ToDouble) {
+    ASSERT_EQ(double(Rational(1, 3)), 1.0 / 3.0);
+    ASSERT_EQ(double(Rational(-22, 7)), -22.0 / 7.0);
+    ASSERT_EQ(float(Rational(2, 3)), 2.0f / 3.0f);
+    ASSERT_EQ(double(Rational(9007199254740993)), 9007199254740992.0); // tie rounds to even
+    ASSERT_EQ(double(Rational(0)), 0.0);
+    BigInteger p = 1;
+    for (int i = 0; i < 1075; ++i)
+        p *= 2;
+    ASSERT_EQ(double(Rational(BigInteger(1), p)), 0.0);                       // half of denorm_min ties to 0
+    ASSERT_EQ(double(Rational(BigInteger(3), p)), 2 * std::numeric_limits<double>::denorm_min());
+    ASSERT_EQ(double(Rational(BigInteger(std::string(400, '9')))), std::numeric_limits<double>::infinity());
+    ASSERT_EQ(double(Rational(BigInteger(-1), BigInteger(std::string(400, '9')))), 0.0);
+}
+
+TEST(Conversion, FromDouble) {
+    ASSERT_EQ(Rational(0.1).toString(), "3602879701896397/36028797018963968");
+    ASSERT_EQ(Rational(-2.5).toString(), "-5/2");
+    ASSERT_EQ(Rational(0.0).toString(), "0");
+    ASSERT_EQ(Rational(1e20).toString(), "100000000000000000000");
+    ASSERT_EQ(Rational(0.5f).toString(), "1/2");
+    ASSERT_EQ(double(Rational(std::numeric_limits<double>::denorm_min())), std::numeric_limits<double>::denorm_min());
+    ASSERT_THROW(Rational(std::numeric_limits<double>::infinity()), std::invalid_argument);
+}
+
+TEST(Conversion, ContinuedFractionAndLimitDenominator) {
+    std::string s;
+    for (BigInteger &t : Rational(415, 93).continuedFraction())
+        s += t.toString() + " ";
+    ASSERT_EQ(s, "4 2 6 7 ");
+    s.clear();
+    for (BigInteger &t : Rational(-7, 3).continuedFraction())
+        s += t.toString() + " ";
+    ASSERT_EQ(s, "-3 1 2 ");
+    Rational pi(3.141592653589793);
+    ASSERT_EQ(pi.limitDenominator(1000).toString(), "355/113");
+    ASSERT_EQ((-pi).limitDenominator(100).toString(), "-311/99");
+    ASSERT_EQ(Rational(0.1).limitDenominator(BigInteger(1000000)).toString(), "1/10");
+    ASSERT_EQ(Rational(3, 7).limitDenominator(7).toString(), "3/7");
+    ASSERT_EQ(Rational(3, 7).limitDenominator(1).toString(), "0");
+    ASSERT_THROW(pi.limitDenominator(0), std::invalid_argument);
+    ASSERT_THROW(pi.limitDenominator(-5), std::invalid_argument);
+}
+
+TEST(Division, ByZeroThrows) {
+    Rational a(3), zero(0), big(BigInteger("123456789012345678901234567890"), BigInteger(7));
+    ASSERT_THROW(a / 0, std::domain_error);
+    ASSERT_THROW(a /= 0, std::domain_error);
+    ASSERT_THROW(a /= zero, std::domain_error);
+    ASSERT_THROW(a / zero, std::domain_error);
+    ASSERT_THROW(5 / zero, std::domain_error);
+    ASSERT_THROW(big / zero, std::domain_error);
+    ASSERT_THROW(big / (big - big), std::domain_error);
+    ASSERT_THROW(zero / zero, std::domain_error);
+    ASSERT_EQ(a.toString(), "3");
+}
+
+TEST(SmallPath, PromotionAndDemotion) {
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    Rational a(max, 3), b(max - 1, 5);
+    ASSERT_EQ((a * b).toString(), "28356863910078205279391178582459241814/5");
+    ASSERT_EQ((a + b).toString(), "73786976294838206453/15");
+    ASSERT_EQ(((a + b) - b).toString(), "9223372036854775807/3"); // back to a word-sized value
+    ASSERT_EQ((Rational(std::numeric_limits<int64_t>::min()) / -1).toString(), "9223372036854775808");
+    ASSERT_EQ((Rational(max) + 1).toString(), "9223372036854775808");
+    ASSERT_EQ((Rational(max) * max / max).toString(), "9223372036854775807");
+    ASSERT_TRUE(Rational(max, 2) > Rational(max - 1, 2));
+    ASSERT_TRUE(Rational(max, max - 1) > 1);
+    ASSERT_EQ(Rational(1, max).numerator(), 1);
+    ASSERT_EQ(Rational(2, -6).denominator(), 3);
+    ASSERT_EQ(Rational(-6, 4).asDecimal(3), "-1.500");
+}
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include "rnsinteger.h"
+#include <string>
+#include <vector>
+
+TEST(RnsInteger, RoundTrip)
+{
+    auto basis = std::make_shared<RnsBasis>(60);
+    ASSERT_EQ(basis->size(), 7);
+    std::vector<std::string> values = {"0", "1", "-1", "123456789012345678901234567890",
+                                       "-999999999999999999999999999999999999999999999999999999999999"};
+    for (const std::string &v : values)
+    {
+        ASSERT_EQ(RnsInteger(basis, BigInteger(v)).toBigInteger().toString(), v);
+    }
+    ASSERT_EQ(RnsInteger(basis, INT64_MIN).toBigInteger().toString(), "-9223372036854775808");
+}
+
+TEST(RnsInteger, PolynomialChain)
+{
+    // evaluates sum_{i<40} (-1)^i (i + 1) * x^i at x = 987654321 both ways
+    auto basis = std::make_shared<RnsBasis>(400);
+    BigInteger x = 987654321, expected = 0, power = 1;
+    RnsInteger rx(basis, x), result(basis), rpower(basis, 1);
+    for (int64_t i = 0; i < 40; ++i)
+    {
+        int64_t coef = (i % 2 == 0) ? i + 1 : -(i + 1);
+        expected += power * coef;
+        result += rpower * RnsInteger(basis, coef);
+        power *= x;
+        rpower *= rx;
+    }
+    ASSERT_EQ(result.toBigInteger(), expected);
+    ASSERT_EQ((result - result).toBigInteger(), 0);
+    ASSERT_EQ((-result).toBigInteger(), -expected);
+}
+
+TEST(RnsInteger, MismatchedBasis)
+{
+    auto basis = std::make_shared<RnsBasis>(60), other = std::make_shared<RnsBasis>(60);
+    RnsInteger a(basis, 5), b(other, 7);
+    ASSERT_THROW(a += b, std::invalid_argument);
+    ASSERT_THROW(a -= b, std::invalid_argument);
+    ASSERT_THROW(a *= b, std::invalid_argument);
+    ASSERT_THROW(a + b, std::invalid_argument);
+    ASSERT_EQ(a.toBigInteger(), 5);
+}
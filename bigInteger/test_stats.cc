@@ -0,0 +1,54 @@
+#define BIGINTEGER_STATS
+#include "gtest/gtest.h"
+#include "biginteger.h"
+#include <string>
+
+TEST(Stats, CountsOperations)
+{
+    BigIntegerStats::reset();
+    BigInteger a = 123456789, b = 987;
+    a += b;
+    a -= b;
+    a *= b;
+    a *= b;
+    a /= b;
+    a %= b;
+    ++a;
+    BigIntegerStats stats = BigIntegerStats::snapshot();
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Add)], 1);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Sub)], 1);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Mul)], 2);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Div)], 1);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Mod)], 1);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::Increment)], 1);
+    ASSERT_GT(stats.allocations, 0);
+    ASSERT_GT(stats.allocatedBytes, 0);
+}
+
+TEST(Stats, SizeHistogram)
+{
+    BigIntegerStats::reset();
+    BigInteger a(std::string(100, '9')), b = 7;
+    a *= b; // 100 digits -> bucket 6
+    BigIntegerStats stats = BigIntegerStats::snapshot();
+    ASSERT_EQ(stats.sizeHistogram[static_cast<size_t>(BigIntegerOp::Mul)][6], 1);
+    ASSERT_STREQ(BigIntegerStats::opName(BigIntegerOp::Mul), "mul");
+}
+
+TEST(Stats, RationalAndReset)
+{
+    // word-sized values never reach the BigInteger gcd, so use 20-digit denominators
+    Rational r(BigInteger(1), BigInteger("30000000000000000000"));
+    BigIntegerStats::reset();
+    r += Rational(BigInteger(1), BigInteger("60000000000000000000"));
+    r.normalize();
+    BigIntegerStats stats = BigIntegerStats::snapshot();
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::RationalAdd)], 1);
+    ASSERT_EQ(stats.ops[static_cast<size_t>(BigIntegerOp::RationalNormalize)], 1);
+    ASSERT_GE(stats.ops[static_cast<size_t>(BigIntegerOp::Gcd)], 1);
+    ASSERT_GT(stats.gcdTime.count(), 0);
+    ASSERT_GT(stats.normalizeTime.count(), 0);
+    ASSERT_EQ(r.toString(), "1/20000000000000000000");
+    BigIntegerStats::reset();
+    ASSERT_EQ(BigIntegerStats::snapshot().ops[static_cast<size_t>(BigIntegerOp::RationalAdd)], 0);
+}
@@ -0,0 +1,494 @@
+#pragma once
+
+#include "../bigInteger/biginteger.h"
+#include <initializer_list>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fraction-free (Bareiss) elimination on a row-major block of BigIntegers. Every intermediate
+// entry is a minor of the input, so entries grow linearly instead of exponentially and all
+// divisions are exact.
+class Bareiss
+{
+private:
+    // columns updated together while the pivot row segment stays in cache
+    static constexpr size_t kBlock = 32;
+    // below this many entries per step the elimination is not worth spawning threads for
+    static constexpr size_t kParallelMinWork = 256;
+
+    static size_t &threadCount()
+    {
+        thread_local size_t count = 1;
+        return count;
+    }
+
+    // a[i][j] = (pivot * a[i][j] - a[i][c] * a[r][j]) / prev for rows [from, to), columns > c
+    static void eliminateRows(std::vector<BigInteger> &a, size_t width, size_t r, size_t c,
+                              const BigInteger &prev, size_t from, size_t to)
+    {
+        const BigInteger &pivot = a[r * width + c];
+        BigInteger t;
+        for (size_t jb = c + 1; jb < width; jb += kBlock)
+        {
+            size_t je = std::min(width, jb + kBlock);
+            for (size_t i = from; i < to; ++i)
+            {
+                const BigInteger &factor = a[i * width + c];
+                bool zero = factor == 0;
+                for (size_t j = jb; j < je; ++j)
+                {
+                    BigInteger &x = a[i * width + j];
+                    x *= pivot;
+                    if (!zero)
+                    {
+                        t = factor;
+                        t *= a[r * width + j];
+                        x -= t;
+                    }
+                    if (prev != 1)
+                    {
+                        x /= prev;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    // Number of threads the row updates of one elimination step are split across. The
+    // setting is per thread, 1 (the default) keeps the elimination serial.
+    static void setThreadCount(size_t count)
+    {
+        threadCount() = std::max<size_t>(count, 1);
+    }
+
+    static size_t getThreadCount()
+    {
+        return threadCount();
+    }
+
+    // Reduces the n x width block to echelon form using pivots from the first `limit`
+    // columns. Returns the rank, stores the pivot columns and flips `negate` on every row
+    // swap. The last pivot of a full-rank square block is its determinant (up to `negate`).
+    static size_t eliminate(std::vector<BigInteger> &a, size_t n, size_t width, size_t limit,
+                            std::vector<size_t> &pivots, bool &negate)
+    {
+        BigInteger prev = 1;
+        size_t r = 0;
+        for (size_t c = 0; c < limit && r < n; ++c)
+        {
+            size_t p = r;
+            while (p < n && a[p * width + c] == 0)
+            {
+                ++p;
+            }
+            if (p == n)
+            {
+                continue;
+            }
+            if (p != r)
+            {
+                for (size_t j = c; j < width; ++j)
+                {
+                    a[p * width + j].swap(a[r * width + j]);
+                }
+                negate = !negate;
+            }
+
+            size_t rest = n - r - 1;
+            size_t threads = std::min(threadCount(), rest);
+            if (threads > 1 && rest * (width - c) >= kParallelMinWork)
+            {
+                std::vector<std::thread> workers;
+                size_t chunk = (rest + threads - 1) / threads;
+                for (size_t from = r + 1; from < n; from += chunk)
+                {
+                    size_t to = std::min(n, from + chunk);
+                    workers.emplace_back([&a, width, r, c, &prev, from, to]() {
+                        eliminateRows(a, width, r, c, prev, from, to);
+                    });
+                }
+                for (std::thread &w : workers)
+                {
+                    w.join();
+                }
+            }
+            else
+            {
+                eliminateRows(a, width, r, c, prev, r + 1, n);
+            }
+            for (size_t i = r + 1; i < n; ++i)
+            {
+                a[i * width + c] = 0;
+            }
+
+            prev = a[r * width + c];
+            pivots.push_back(c);
+            ++r;
+        }
+        return r;
+    }
+
+    // For an eliminated full-rank n x (n + m) block [A | B] returns Y with A * (Y / D) = B,
+    // where D is the last pivot; every step divides exactly by Cramer's rule.
+    static std::vector<BigInteger> backSubstitute(const std::vector<BigInteger> &a, size_t n, size_t m)
+    {
+        size_t width = n + m;
+        const BigInteger &d = a[(n - 1) * width + n - 1];
+        std::vector<BigInteger> y(n * m);
+        BigInteger t;
+        for (size_t k = 0; k < m; ++k)
+        {
+            for (size_t i = n; i-- > 0;)
+            {
+                BigInteger &x = y[i * m + k];
+                x = a[i * width + n + k];
+                x *= d;
+                for (size_t j = i + 1; j < n; ++j)
+                {
+                    t = a[i * width + j];
+                    t *= y[j * m + k];
+                    x -= t;
+                }
+                x /= a[i * width + i];
+            }
+        }
+        return y;
+    }
+};
+
+// Dense row-major matrix over BigInteger or Rational. Determinant, rank, inverse and solve
+// clear denominators row by row and run Bareiss elimination over BigInteger, so no Rational
+// is formed until the final results.
+template <typename Field = Rational>
+class Matrix
+{
+    static_assert(std::is_same<Field, BigInteger>::value || std::is_same<Field, Rational>::value,
+                  "Matrix supports BigInteger and Rational entries");
+
+private:
+    size_t rows_;
+    size_t columns_;
+    std::vector<Field> data_;
+
+    // lcm of the denominators in row i, 1 for integer matrices
+    BigInteger rowScale(size_t i) const
+    {
+        BigInteger scale = 1;
+        if constexpr (std::is_same<Field, Rational>::value)
+        {
+            for (size_t j = 0; j < columns_; ++j)
+            {
+                BigInteger d = data_[i * columns_ + j].denominator();
+                if (d == 1)
+                {
+                    continue;
+                }
+                BigInteger a = scale, b = d;
+                scale *= d / gcd(a, b);
+            }
+        }
+        return scale;
+    }
+
+    static BigInteger scaled(const Field &x, const BigInteger &scale)
+    {
+        if constexpr (std::is_same<Field, Rational>::value)
+        {
+            BigInteger n = x.numerator();
+            if (scale != 1)
+            {
+                n *= scale / x.denominator();
+            }
+            return n;
+        }
+        else
+        {
+            return x;
+        }
+    }
+
+    // integer rows [s_i * A_i | s_i * B_i]; returns the product of the row scales s_i
+    BigInteger toIntegers(const Matrix *rhs, std::vector<BigInteger> &a) const
+    {
+        size_t extra = rhs ? rhs->columns_ : 0;
+        size_t width = columns_ + extra;
+        a.assign(rows_ * width, BigInteger(0));
+        BigInteger product = 1;
+        for (size_t i = 0; i < rows_; ++i)
+        {
+            BigInteger scale = rowScale(i);
+            if (rhs)
+            {
+                BigInteger s = rhs->rowScale(i);
+                BigInteger x = scale, y = s;
+                scale *= s / gcd(x, y);
+            }
+            for (size_t j = 0; j < columns_; ++j)
+            {
+                a[i * width + j] = scaled(data_[i * columns_ + j], scale);
+            }
+            for (size_t j = 0; j < extra; ++j)
+            {
+                a[i * width + columns_ + j] = scaled(rhs->data_[i * extra + j], scale);
+            }
+            product *= scale;
+        }
+        return product;
+    }
+
+    // X with (*this) * X = rhs for a square non-singular matrix
+    Matrix<Rational> solveMatrix(const Matrix &rhs) const
+    {
+        if (rows_ != columns_ || rhs.rows_ != rows_)
+        {
+            throw std::invalid_argument("Matrix: solve needs a square matrix and matching right-hand side");
+        }
+        size_t n = rows_, m = rhs.columns_;
+        std::vector<BigInteger> a;
+        toIntegers(&rhs, a);
+        std::vector<size_t> pivots;
+        bool negate = false;
+        if (Bareiss::eliminate(a, n, n + m, n, pivots, negate) < n)
+        {
+            throw std::domain_error("Matrix: matrix is singular");
+        }
+        std::vector<BigInteger> y = Bareiss::backSubstitute(a, n, m);
+        const BigInteger &d = a[(n - 1) * (n + m) + n - 1];
+        Matrix<Rational> res(n, m);
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t k = 0; k < m; ++k)
+            {
+                res(i, k) = Rational(y[i * m + k], d);
+            }
+        }
+        return res;
+    }
+
+public:
+    Matrix(size_t rows, size_t columns, const Field &value = Field(0))
+        : rows_(rows), columns_(columns), data_(rows * columns, value)
+    {
+    }
+
+    Matrix(std::initializer_list<std::initializer_list<Field>> init)
+        : rows_(init.size()), columns_(init.size() ? init.begin()->size() : 0)
+    {
+        data_.reserve(rows_ * columns_);
+        for (const std::initializer_list<Field> &row : init)
+        {
+            if (row.size() != columns_)
+            {
+                throw std::invalid_argument("Matrix: rows have different lengths");
+            }
+            data_.insert(data_.end(), row.begin(), row.end());
+        }
+    }
+
+    static Matrix identity(size_t n)
+    {
+        Matrix res(n, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            res(i, i) = Field(1);
+        }
+        return res;
+    }
+
+    size_t getRows() const
+    {
+        return rows_;
+    }
+
+    size_t getColumns() const
+    {
+        return columns_;
+    }
+
+    Field &operator()(size_t i, size_t j)
+    {
+        return data_[i * columns_ + j];
+    }
+
+    const Field &operator()(size_t i, size_t j) const
+    {
+        return data_[i * columns_ + j];
+    }
+
+    bool operator==(const Matrix &x) const
+    {
+        return rows_ == x.rows_ && columns_ == x.columns_ && data_ == x.data_;
+    }
+
+    bool operator!=(const Matrix &x) const
+    {
+        return !(*this == x);
+    }
+
+    Matrix &operator+=(const Matrix &x)
+    {
+        if (rows_ != x.rows_ || columns_ != x.columns_)
+        {
+            throw std::invalid_argument("Matrix: dimensions do not match");
+        }
+        for (size_t i = 0; i < data_.size(); ++i)
+        {
+            data_[i] += x.data_[i];
+        }
+        return *this;
+    }
+
+    Matrix &operator-=(const Matrix &x)
+    {
+        if (rows_ != x.rows_ || columns_ != x.columns_)
+        {
+            throw std::invalid_argument("Matrix: dimensions do not match");
+        }
+        for (size_t i = 0; i < data_.size(); ++i)
+        {
+            data_[i] -= x.data_[i];
+        }
+        return *this;
+    }
+
+    Matrix &operator*=(const Field &x)
+    {
+        for (Field &v : data_)
+        {
+            v *= x;
+        }
+        return *this;
+    }
+
+    Matrix &operator*=(const Matrix &x)
+    {
+        *this = *this * x;
+        return *this;
+    }
+
+    friend Matrix operator+(Matrix a, const Matrix &b)
+    {
+        return a += b;
+    }
+
+    friend Matrix operator-(Matrix a, const Matrix &b)
+    {
+        return a -= b;
+    }
+
+    friend Matrix operator*(Matrix a, const Field &x)
+    {
+        return a *= x;
+    }
+
+    // i-k-j order walks both operands and the result row by row
+    friend Matrix operator*(const Matrix &a, const Matrix &b)
+    {
+        if (a.columns_ != b.rows_)
+        {
+            throw std::invalid_argument("Matrix: dimensions do not match");
+        }
+        Matrix res(a.rows_, b.columns_);
+        Field t(0);
+        for (size_t i = 0; i < a.rows_; ++i)
+        {
+            for (size_t k = 0; k < a.columns_; ++k)
+            {
+                const Field &x = a(i, k);
+                if (x == Field(0))
+                {
+                    continue;
+                }
+                for (size_t j = 0; j < b.columns_; ++j)
+                {
+                    t = x;
+                    t *= b(k, j);
+                    res(i, j) += t;
+                }
+            }
+        }
+        return res;
+    }
+
+    Matrix transposed() const
+    {
+        Matrix res(columns_, rows_);
+        for (size_t i = 0; i < rows_; ++i)
+        {
+            for (size_t j = 0; j < columns_; ++j)
+            {
+                res(j, i) = (*this)(i, j);
+            }
+        }
+        return res;
+    }
+
+    Field det() const
+    {
+        if (rows_ != columns_)
+        {
+            throw std::invalid_argument("Matrix: determinant of a non-square matrix");
+        }
+        if (rows_ == 0)
+        {
+            return Field(1);
+        }
+        std::vector<BigInteger> a;
+        BigInteger scale = toIntegers(nullptr, a);
+        std::vector<size_t> pivots;
+        bool negate = false;
+        if (Bareiss::eliminate(a, rows_, columns_, columns_, pivots, negate) < rows_)
+        {
+            return Field(0);
+        }
+        BigInteger d = a.back();
+        if (negate)
+        {
+            d = -d;
+        }
+        if constexpr (std::is_same<Field, Rational>::value)
+        {
+            return Rational(d, scale);
+        }
+        else
+        {
+            return d;
+        }
+    }
+
+    size_t rank() const
+    {
+        std::vector<BigInteger> a;
+        toIntegers(nullptr, a);
+        std::vector<size_t> pivots;
+        bool negate = false;
+        return Bareiss::eliminate(a, rows_, columns_, columns_, pivots, negate);
+    }
+
+    // throws std::domain_error for a singular matrix
+    Matrix<Rational> inverted() const
+    {
+        return solveMatrix(identity(rows_));
+    }
+
+    // x with (*this) * x = b, throws std::domain_error for a singular matrix
+    std::vector<Rational> solve(const std::vector<Field> &b) const
+    {
+        Matrix rhs(b.size(), 1);
+        for (size_t i = 0; i < b.size(); ++i)
+        {
+            rhs(i, 0) = b[i];
+        }
+        Matrix<Rational> x = solveMatrix(rhs);
+        std::vector<Rational> res;
+        res.reserve(x.getRows());
+        for (size_t i = 0; i < x.getRows(); ++i)
+        {
+            res.push_back(x(i, 0));
+        }
+        return res;
+    }
+};
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+#include "matrix.h"
+#include <string>
+#include <vector>
+
+static Matrix<Rational> hilbert(size_t n)
+{
+    Matrix<Rational> h(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            h(i, j) = Rational(1, i + j + 1);
+    return h;
+}
+
+TEST(Matrix, Arithmetic)
+{
+    Matrix<Rational> a = {{1, 2}, {3, 4}};
+    Matrix<Rational> b = {{Rational(1, 2), 0}, {0, Rational(-1, 3)}};
+    Matrix<Rational> sum = {{Rational(3, 2), 2}, {3, Rational(11, 3)}};
+    Matrix<Rational> product = {{Rational(1, 2), Rational(-2, 3)}, {Rational(3, 2), Rational(-4, 3)}};
+    ASSERT_EQ(a + b, sum);
+    ASSERT_EQ(a * b, product);
+    ASSERT_EQ(a * b - product, Matrix<Rational>(2, 2));
+    ASSERT_EQ(a.transposed(), (Matrix<Rational>{{1, 3}, {2, 4}}));
+    ASSERT_EQ(a * Matrix<Rational>::identity(2), a);
+    ASSERT_THROW(a * Matrix<Rational>(3, 1), std::invalid_argument);
+}
+
+TEST(Matrix, DeterminantAndRank)
+{
+    Matrix<BigInteger> a = {{2, -1, 0}, {-1, 2, -1}, {0, -1, 2}};
+    ASSERT_EQ(a.det(), 4);
+    Matrix<BigInteger> swapped = {{0, 1, 2}, {1, 2, 3}, {3, 1, 1}};
+    ASSERT_EQ(swapped.det(), -2);
+    Matrix<BigInteger> singular = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    ASSERT_EQ(singular.det(), 0);
+    ASSERT_EQ(singular.rank(), 2);
+    Matrix<BigInteger> wide = {{0, 0, 1, 2}, {0, 0, 2, 4}, {1, 0, 0, 1}};
+    ASSERT_EQ(wide.rank(), 2);
+    ASSERT_EQ(hilbert(5).det().toString(), "1/266716800000");
+    ASSERT_EQ(hilbert(6).rank(), 6);
+    ASSERT_THROW(wide.det(), std::invalid_argument);
+}
+
+TEST(Matrix, InverseAndSolve)
+{
+    for (size_t n = 1; n <= 8; ++n)
+    {
+        Matrix<Rational> h = hilbert(n);
+        Matrix<Rational> inv = h.inverted();
+        ASSERT_EQ(h * inv, Matrix<Rational>::identity(n));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                ASSERT_EQ(inv(i, j).denominator(), 1); // the inverse Hilbert matrix is integral
+    }
+    ASSERT_EQ(hilbert(4).inverted()(3, 3).toString(), "2800");
+
+    Matrix<BigInteger> a = {{0, 2, 1}, {1, 1, 1}, {2, 1, 0}};
+    std::vector<Rational> x = a.solve({BigInteger(3), BigInteger(1), BigInteger(-2)});
+    ASSERT_EQ(x[0].toString() + " " + x[1].toString() + " " + x[2].toString(), "-4/3 2/3 5/3");
+    ASSERT_THROW(Matrix<Rational>({{1, 2}, {2, 4}}).inverted(), std::domain_error);
+}
+
+TEST(Matrix, ParallelMatchesSerial)
+{
+    size_t n = 24;
+    Matrix<BigInteger> a(n, n);
+    uint64_t seed = 12345;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            a(i, j) = int64_t(seed >> 40) % 1000 - 500;
+        }
+    BigInteger serial = a.det();
+    Matrix<Rational> inv = Matrix<Rational>(hilbert(n / 2)).inverted();
+    Bareiss::setThreadCount(4);
+    ASSERT_EQ(a.det(), serial);
+    ASSERT_EQ(hilbert(n / 2).inverted(), inv);
+    Bareiss::setThreadCount(1);
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "string.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// One occurrence of a pattern: its index in the PatternSet and the position of its first
+// character in the scanned text (counted from the start of the stream for a Scanner)
+struct PatternMatch
+{
+    size_t position;
+    size_t pattern;
+
+    bool operator==(const PatternMatch &x) const
+    {
+        return position == x.position && pattern == x.pattern;
+    }
+};
+
+// Aho-Corasick automaton over a fixed list of patterns; a text is scanned once whatever the
+// number of patterns. Failure links are folded into a complete transition table, so each
+// input byte costs one table lookup. Bytes are first mapped to classes (bytes that occur in
+// no pattern share class 0), which keeps the table rows as narrow as the patterns' alphabet,
+// and rows are addressed by precomputed offsets that also carry the "a match ends here" bit.
+class PatternSet
+{
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    uint16_t classOf_[256] = {};
+    size_t classes_ = 1;
+    // entry at row + class: row offset of the next state, shifted left by one, with the low
+    // bit set when that state or one of its suffixes ends a pattern
+    std::vector<uint32_t> next_;
+    std::vector<uint8_t> reportable_;
+    std::vector<uint32_t> outputStart_, outputs_; // patterns ending exactly at each state, CSR
+    std::vector<uint32_t> dictLink_;  // nearest proper suffix state that ends a pattern
+    std::vector<size_t> lengths_;
+
+    // Calls f(pattern) for every pattern that ends at the state with the given row offset
+    template <typename F>
+    void forEachOutput(uint32_t row, F &&f) const
+    {
+        for (uint32_t s = row / classes_; s != kNone; s = dictLink_[s])
+        {
+            for (uint32_t k = outputStart_[s]; k < outputStart_[s + 1]; ++k)
+            {
+                f(outputs_[k]);
+            }
+        }
+    }
+
+    // Runs the automaton over data[0, n) from `row`; `offset` is the stream position of data[0]
+    uint32_t run(uint32_t row, const char *data, size_t n, size_t offset, std::vector<PatternMatch> &out) const
+    {
+        const uint32_t *next = next_.data();
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint32_t entry = next[row + classOf_[static_cast<unsigned char>(data[i])]];
+            row = entry >> 1;
+            if (entry & 1)
+            {
+                size_t end = offset + i + 1;
+                forEachOutput(row, [&](uint32_t p) { out.push_back(PatternMatch{end - lengths_[p], p}); });
+            }
+        }
+        return row;
+    }
+
+public:
+    // Incremental scan of a text delivered in chunks; matches that straddle chunk
+    // boundaries are reported by the feed() call that completes them
+    class Scanner
+    {
+    private:
+        const PatternSet *set_;
+        uint32_t row_ = 0;
+        size_t offset_ = 0;
+
+    public:
+        explicit Scanner(const PatternSet &set) : set_(&set)
+        {
+        }
+
+        void feed(const char *data, size_t n, std::vector<PatternMatch> &out)
+        {
+            row_ = set_->run(row_, data, n, offset_, out);
+            offset_ += n;
+        }
+
+        void feed(StringView chunk, std::vector<PatternMatch> &out)
+        {
+            feed(chunk.data(), chunk.length(), out);
+        }
+
+        // Bytes consumed so far
+        size_t offset() const
+        {
+            return offset_;
+        }
+
+        void reset()
+        {
+            row_ = 0;
+            offset_ = 0;
+        }
+    };
+
+    // Throws std::invalid_argument on an empty pattern; duplicates are reported separately
+    explicit PatternSet(const std::vector<String> &patterns)
+    {
+        for (const String &p : patterns)
+        {
+            if (p.empty())
+            {
+                throw std::invalid_argument("PatternSet: empty pattern");
+            }
+            for (size_t i = 0; i < p.length(); ++i)
+            {
+                uint16_t &c = classOf_[static_cast<unsigned char>(p[i])];
+                if (c == 0)
+                {
+                    c = static_cast<uint16_t>(classes_++);
+                }
+            }
+        }
+
+        // trie in a flat table, kNone for missing edges
+        std::vector<uint32_t> trie(classes_, kNone);
+        std::vector<std::vector<uint32_t>> ends(1);
+        for (size_t id = 0; id < patterns.size(); ++id)
+        {
+            const String &p = patterns[id];
+            size_t state = 0;
+            for (size_t i = 0; i < p.length(); ++i)
+            {
+                size_t c = classOf_[static_cast<unsigned char>(p[i])];
+                if (trie[state * classes_ + c] == kNone)
+                {
+                    trie[state * classes_ + c] = static_cast<uint32_t>(ends.size());
+                    trie.resize(trie.size() + classes_, kNone);
+                    ends.emplace_back();
+                }
+                state = trie[state * classes_ + c];
+            }
+            ends[state].push_back(static_cast<uint32_t>(id));
+            lengths_.push_back(p.length());
+        }
+        size_t states = ends.size();
+        if (states * classes_ >= kNone / 2)
+        {
+            throw std::length_error("PatternSet: too many states");
+        }
+
+        // breadth-first: fold failure links into the table and derive the dictionary links
+        std::vector<uint32_t> fail(states, 0), order;
+        dictLink_.assign(states, kNone);
+        reportable_.assign(states, 0);
+        order.reserve(states);
+        for (size_t c = 0; c < classes_; ++c)
+        {
+            uint32_t &v = trie[c];
+            if (v == kNone)
+            {
+                v = 0;
+            }
+            else
+            {
+                order.push_back(v);
+            }
+        }
+        for (size_t head = 0; head < order.size(); ++head)
+        {
+            uint32_t u = order[head];
+            uint32_t f = fail[u];
+            dictLink_[u] = ends[f].empty() ? dictLink_[f] : f;
+            reportable_[u] = !ends[u].empty() || dictLink_[u] != kNone;
+            for (size_t c = 0; c < classes_; ++c)
+            {
+                uint32_t &v = trie[u * classes_ + c];
+                if (v == kNone)
+                {
+                    v = trie[f * classes_ + c];
+                }
+                else
+                {
+                    fail[v] = trie[f * classes_ + c];
+                    order.push_back(v);
+                }
+            }
+        }
+
+        next_.resize(trie.size());
+        for (size_t i = 0; i < trie.size(); ++i)
+        {
+            next_[i] = static_cast<uint32_t>(trie[i] * classes_) << 1 | reportable_[trie[i]];
+        }
+        outputStart_.assign(states + 1, 0);
+        for (size_t s = 0; s < states; ++s)
+        {
+            outputStart_[s + 1] = outputStart_[s] + static_cast<uint32_t>(ends[s].size());
+            outputs_.insert(outputs_.end(), ends[s].begin(), ends[s].end());
+        }
+    }
+
+    // Number of patterns
+    size_t size() const
+    {
+        return lengths_.size();
+    }
+
+    // Number of automaton states, the table holds states() * alphabet classes entries
+    size_t states() const
+    {
+        return reportable_.size();
+    }
+
+    // Every occurrence of every pattern, ordered by end position and longest first among
+    // matches that end together
+    std::vector<PatternMatch> findAll(StringView text) const
+    {
+        std::vector<PatternMatch> out;
+        run(0, text.data(), text.length(), 0, out);
+        return out;
+    }
+
+    Scanner scanner() const
+    {
+        return Scanner(*this);
+    }
+};
@@ -1,77 +1,571 @@
+#pragma once
+
 #include <iostream>
 #include <fstream>
 #include <cstring>
 #include <algorithm>
+#include <cstddef>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Substring search over raw character ranges; every function returns n (the haystack
+// length) when there is no match. Needles up to kPrefilterMax bytes go through a scan that
+// compares the first and last needle byte against 16 positions at once (SSE2) and only
+// memcmp()s the candidates. Longer needles use the Two-Way algorithm of Crochemore and
+// Perrin, linear in n + m, with a last-byte skip table in front of each window; rfind runs
+// it on the reversed strings.
+class StringSearch
+{
+private:
+    static constexpr size_t kPrefilterMax = 32;
 
-class String
+    // Characters of p[0, n), read forwards or backwards
+    template <bool Reverse>
+    struct Sequence
+    {
+        const unsigned char *p;
+        size_t n;
+
+        unsigned char operator[](size_t i) const
+        {
+            return Reverse ? p[n - 1 - i] : p[i];
+        }
+    };
+
+    // Start of the maximal suffix of x for the alphabet order (or its reverse if `tilde`),
+    // as a signed index that is -1 for the whole string; `period` receives its period
+    template <typename Seq>
+    static ptrdiff_t maximalSuffix(const Seq &x, size_t m, size_t &period, bool tilde)
+    {
+        ptrdiff_t ms = -1;
+        size_t j = 0, k = 1;
+        period = 1;
+        while (j + k < m)
+        {
+            unsigned char a = x[j + k], b = x[ms + k];
+            if (tilde ? a > b : a < b)
+            {
+                j += k;
+                k = 1;
+                period = j - ms;
+            }
+            else if (a == b)
+            {
+                if (k != period)
+                {
+                    ++k;
+                }
+                else
+                {
+                    j += period;
+                    k = 1;
+                }
+            }
+            else
+            {
+                ms = j;
+                j = ms + 1;
+                k = period = 1;
+            }
+        }
+        return ms;
+    }
+
+    // First occurrence of x (m >= 1) in y[from, n), or n
+    template <typename Seq>
+    static size_t twoWay(const Seq &y, size_t n, const Seq &x, size_t m, size_t from)
+    {
+        size_t p, q;
+        ptrdiff_t i = maximalSuffix(x, m, p, false), j = maximalSuffix(x, m, q, true);
+        ptrdiff_t ell = std::max(i, j);
+        size_t per = (i > j) ? p : q;
+
+        bool periodic = per + ell + 1 <= m;
+        for (ptrdiff_t k = 0; periodic && k <= ell; ++k)
+        {
+            periodic = x[k] == x[k + per];
+        }
+
+        // distance from the last occurrence of each byte to the end of x, so windows whose
+        // last byte cannot line up with x are skipped before Two-Way looks at them
+        size_t skip[256];
+        std::fill(skip, skip + 256, m);
+        for (size_t k = 0; k < m; ++k)
+        {
+            skip[x[k]] = m - 1 - k;
+        }
+
+        ptrdiff_t sm = static_cast<ptrdiff_t>(m);
+        size_t pos = from;
+        if (periodic)
+        {
+            // after a full match shift by the period and remember the verified prefix
+            ptrdiff_t memory = -1;
+            while (pos + m <= n)
+            {
+                size_t s = skip[y[pos + m - 1]];
+                if (s != 0)
+                {
+                    if (memory != -1 && s < per)
+                    {
+                        s = m - per;
+                    }
+                    memory = -1;
+                    pos += s;
+                    continue;
+                }
+                ptrdiff_t k = std::max(ell, memory) + 1;
+                while (k < sm && x[k] == y[pos + k])
+                {
+                    ++k;
+                }
+                if (k >= sm)
+                {
+                    k = ell;
+                    while (k > memory && x[k] == y[pos + k])
+                    {
+                        --k;
+                    }
+                    if (k <= memory)
+                    {
+                        return pos;
+                    }
+                    pos += per;
+                    memory = sm - static_cast<ptrdiff_t>(per) - 1;
+                }
+                else
+                {
+                    pos += k - ell;
+                    memory = -1;
+                }
+            }
+        }
+        else
+        {
+            size_t shift = std::max<size_t>(ell + 1, m - ell - 1) + 1;
+            while (pos + m <= n)
+            {
+                size_t s = skip[y[pos + m - 1]];
+                if (s != 0)
+                {
+                    pos += s;
+                    continue;
+                }
+                ptrdiff_t k = ell + 1;
+                while (k < sm && x[k] == y[pos + k])
+                {
+                    ++k;
+                }
+                if (k >= sm)
+                {
+                    k = ell;
+                    while (k >= 0 && x[k] == y[pos + k])
+                    {
+                        --k;
+                    }
+                    if (k < 0)
+                    {
+                        return pos;
+                    }
+                    pos += shift;
+                }
+                else
+                {
+                    pos += k - ell;
+                }
+            }
+        }
+        return n;
+    }
+
+    static bool matchesAt(const char *h, size_t i, const char *t, size_t m)
+    {
+        return h[i] == t[0] && h[i + m - 1] == t[m - 1] && (m <= 2 || memcmp(h + i + 1, t + 1, m - 2) == 0);
+    }
+
+    // Candidates i in [from, last] for 1 <= m <= kPrefilterMax
+    static size_t prefilterForward(const char *h, size_t n, const char *t, size_t m, size_t from, size_t last)
+    {
+        size_t i = from;
+#ifdef __SSE2__
+        const __m128i first = _mm_set1_epi8(t[0]), tail = _mm_set1_epi8(t[m - 1]);
+        for (; i + 16 <= last + 1; i += 16)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + m - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, tail)));
+            while (mask != 0)
+            {
+                size_t bit = __builtin_ctz(mask);
+                if (m <= 2 || memcmp(h + i + bit + 1, t + 1, m - 2) == 0)
+                {
+                    return i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i <= last; ++i)
+        {
+            const void *c = memchr(h + i, t[0], last + 1 - i);
+            if (c == nullptr)
+            {
+                break;
+            }
+            i = static_cast<const char *>(c) - h;
+            if (matchesAt(h, i, t, m))
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    static size_t prefilterBackward(const char *h, size_t n, const char *t, size_t m, size_t last)
+    {
+        size_t end = last + 1; // candidates left to check are [0, end)
+#ifdef __SSE2__
+        const __m128i first = _mm_set1_epi8(t[0]), tail = _mm_set1_epi8(t[m - 1]);
+        for (; end >= 16; end -= 16)
+        {
+            size_t i = end - 16;
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + m - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, tail)));
+            while (mask != 0)
+            {
+                size_t bit = 31 - __builtin_clz(mask);
+                if (m <= 2 || memcmp(h + i + bit + 1, t + 1, m - 2) == 0)
+                {
+                    return i + bit;
+                }
+                mask ^= 1u << bit;
+            }
+        }
+#endif
+        for (; end > 0; --end)
+        {
+            if (matchesAt(h, end - 1, t, m))
+            {
+                return end - 1;
+            }
+        }
+        return n;
+    }
+
+public:
+    // First occurrence of t[0, m) in h[0, n) starting at or after pos
+    static size_t find(const char *h, size_t n, const char *t, size_t m, size_t pos = 0)
+    {
+        if (pos > n || m > n - pos)
+        {
+            return n;
+        }
+        if (m == 0)
+        {
+            return pos;
+        }
+        if (m == 1)
+        {
+            const void *c = memchr(h + pos, t[0], n - pos);
+            return (c == nullptr) ? n : static_cast<const char *>(c) - h;
+        }
+        if (m <= kPrefilterMax)
+        {
+            return prefilterForward(h, n, t, m, pos, n - m);
+        }
+        Sequence<false> y{reinterpret_cast<const unsigned char *>(h), n};
+        Sequence<false> x{reinterpret_cast<const unsigned char *>(t), m};
+        return twoWay(y, n, x, m, pos);
+    }
+
+    // Last occurrence of t[0, m) in h[0, n) starting at or before pos
+    static size_t rfind(const char *h, size_t n, const char *t, size_t m, size_t pos = static_cast<size_t>(-1))
+    {
+        if (m > n)
+        {
+            return n;
+        }
+        size_t last = std::min(pos, n - m);
+        if (m == 0)
+        {
+            return last;
+        }
+        if (m <= kPrefilterMax)
+        {
+            return prefilterBackward(h, n, t, m, last);
+        }
+        // the first match in the reversed prefix h[0, last + m) is the last one here
+        size_t limit = last + m;
+        Sequence<true> y{reinterpret_cast<const unsigned char *>(h), limit};
+        Sequence<true> x{reinterpret_cast<const unsigned char *>(t), m};
+        size_t r = twoWay(y, limit, x, m, 0);
+        return (r == limit) ? n : limit - r - m;
+    }
+};
+
+// Non-owning, read-only slice of characters; valid only as long as the characters it
+// points to. String converts to it implicitly, so the search and comparison APIs take views
+// and neither literals nor slices have to be copied into a String first.
+class StringView
 {
 private:
+    const char *str_ = nullptr;
     size_t sz_ = 0;
-    size_t capacity_ = 0;
-    char *str_ = nullptr;
 
-    void increaseCapacity(size_t x)
+public:
+    StringView() = default;
+
+    StringView(const char *str) : str_(str), sz_(strlen(str))
+    {
+    }
+
+    StringView(const char *str, size_t sz) : str_(str), sz_(sz)
+    {
+    }
+
+    const char &operator[](const size_t i) const
+    {
+        return str_[i];
+    }
+
+    const char *data() const
+    {
+        return str_;
+    }
+
+    size_t length() const
+    {
+        return sz_;
+    }
+
+    bool empty() const
+    {
+        return (sz_ == 0);
+    }
+
+    const char &front() const
+    {
+        return str_[0];
+    }
+
+    const char &back() const
+    {
+        return str_[sz_ - 1];
+    }
+
+    // Characters [start, start + count), which must lie inside the view; nothing is copied
+    StringView substr(const size_t start, const size_t count) const
+    {
+        return StringView(str_ + start, count);
+    }
+
+    size_t find(StringView t, size_t pos = 0) const
+    {
+        return StringSearch::find(str_, sz_, t.str_, t.sz_, pos);
+    }
+
+    size_t rfind(StringView t, size_t pos = static_cast<size_t>(-1)) const
+    {
+        return StringSearch::rfind(str_, sz_, t.str_, t.sz_, pos);
+    }
+
+    size_t find(char c, size_t pos = 0) const
+    {
+        return StringSearch::find(str_, sz_, &c, 1, pos);
+    }
+
+    size_t rfind(char c, size_t pos = static_cast<size_t>(-1)) const
+    {
+        return StringSearch::rfind(str_, sz_, &c, 1, pos);
+    }
+};
+
+// Strings of up to kSmallCapacity characters live inline in the object; longer ones on the
+// heap. The last byte of the object is the tag: below kHeapTag it is the inline length, in
+// heap mode it is the byte of the capacity word that encodeCapacity() keeps set to kHeapTag.
+class String
+{
+private:
+    struct Heap
+    {
+        char *str;
+        size_t sz;
+        size_t capacity; // encoded, see encodeCapacity()
+    };
+
+    static constexpr size_t kSmallCapacity = sizeof(Heap) - 1;
+    static constexpr unsigned char kHeapTag = 0x80;
+
+    union
+    {
+        Heap heap_;
+        char small_[sizeof(Heap)] = {};
+    };
+
+    // The tag byte overlaps the capacity word: its lowest byte on big-endian targets, its
+    // highest on little-endian ones. The capacity is stored around that byte.
+    static size_t encodeCapacity(size_t capacity)
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return (capacity << 8) | kHeapTag;
+#else
+        return capacity | (static_cast<size_t>(kHeapTag) << (8 * (sizeof(size_t) - 1)));
+#endif
+    }
+
+    static size_t decodeCapacity(size_t capacity)
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return capacity >> 8;
+#else
+        return capacity & ~(static_cast<size_t>(0xff) << (8 * (sizeof(size_t) - 1)));
+#endif
+    }
+
+    bool isSmall() const
+    {
+        return static_cast<unsigned char>(small_[kSmallCapacity]) < kHeapTag;
+    }
+
+    char *data()
+    {
+        return isSmall() ? small_ : heap_.str;
+    }
+
+    const char *data() const
+    {
+        return isSmall() ? small_ : heap_.str;
+    }
+
+    size_t capacity() const
+    {
+        return isSmall() ? kSmallCapacity : decodeCapacity(heap_.capacity);
+    }
+
+    void setSize(size_t sz)
     {
-        if (x == 0)
+        if (isSmall())
         {
-            capacity_ = 1;
+            small_[kSmallCapacity] = static_cast<char>(sz);
         }
         else
         {
-            capacity_ = x * 2;
+            heap_.sz = sz;
+        }
+    }
+
+    // Frees the heap buffer, if any, and leaves an empty inline string
+    void release()
+    {
+        if (!isSmall())
+        {
+            delete[] heap_.str;
+        }
+        memset(small_, 0, sizeof(small_));
+    }
+
+    // Uninitialized storage for sz characters, inline when they fit
+    char *allocate(size_t sz)
+    {
+        if (sz <= kSmallCapacity)
+        {
+            small_[kSmallCapacity] = static_cast<char>(sz);
+            return small_;
         }
-        char *new_str = new char[capacity_];
-        std::copy(str_, str_ + sz_, new_str);
-        delete[] str_;
-        str_ = new_str;
+        heap_.str = new char[sz];
+        heap_.sz = sz;
+        heap_.capacity = encodeCapacity(sz);
+        return heap_.str;
+    }
+
+    // Moves the characters to a buffer of the given capacity, inline if it fits
+    void reallocate(size_t new_capacity)
+    {
+        size_t sz = length();
+        if (new_capacity <= kSmallCapacity)
+        {
+            if (!isSmall())
+            {
+                char *old = heap_.str;
+                memcpy(small_, old, sz);
+                small_[kSmallCapacity] = static_cast<char>(sz);
+                delete[] old;
+            }
+            return;
+        }
+        char *new_str = new char[new_capacity];
+        memcpy(new_str, data(), sz);
+        release();
+        heap_.str = new_str;
+        heap_.sz = sz;
+        heap_.capacity = encodeCapacity(new_capacity);
     }
 
     void decreaseCapacity()
     {
-        char *new_str = new char[capacity_ / 2];
-        std::copy(str_, str_ + sz_, new_str);
-        delete[] str_;
-        str_ = new_str;
+        reallocate(capacity() / 2);
+    }
+
+    // Appends n characters that may point into this string
+    void append(const char *s, size_t n)
+    {
+        size_t sz = length();
+        if (sz + n > capacity())
+        {
+            size_t new_capacity = std::max(2 * capacity(), sz + n);
+            char *new_str = new char[new_capacity];
+            memcpy(new_str, data(), sz);
+            memcpy(new_str + sz, s, n);
+            release();
+            heap_.str = new_str;
+            heap_.sz = sz + n;
+            heap_.capacity = encodeCapacity(new_capacity);
+            return;
+        }
+        memcpy(data() + sz, s, n);
+        setSize(sz + n);
     }
 
 public:
     String(const char *str)
     {
-        sz_ = strlen(str);
-        capacity_ = sz_;
-        str_ = new char[capacity_];
-        std::copy(str, str + sz_, str_);
+        size_t sz = strlen(str);
+        memcpy(allocate(sz), str, sz);
     }
 
     String(size_t sz, char c = '\0')
     {
-        sz_ = sz;
-        capacity_ = sz_;
-        str_ = new char[capacity_];
-        memset(str_, c, sz_);
+        memset(allocate(sz), c, sz);
     }
 
     String(const char c)
     {
-        sz_ = 1;
-        capacity_ = sz_;
-        str_ = new char[capacity_];
-        str_[0] = c;
+        allocate(1)[0] = c;
+    }
+
+    explicit String(StringView s)
+    {
+        memcpy(allocate(s.length()), s.data(), s.length());
     }
 
     String(const String &a)
     {
-        sz_ = a.sz_;
-        capacity_ = a.capacity_;
-        str_ = new char[capacity_];
-        std::copy(a.str_, a.str_ + sz_, str_);
+        memcpy(allocate(a.length()), a.data(), a.length());
+    }
+
+    String(String &&a) noexcept
+    {
+        memcpy(small_, a.small_, sizeof(small_));
+        memset(a.small_, 0, sizeof(a.small_));
     }
 
     String() = default;
 
     ~String()
     {
-        delete[] str_;
+        release();
     }
 
     String &operator=(String s)
@@ -82,139 +576,111 @@ public:
 
     void swap(String &s)
     {
-        std::swap(s.sz_, sz_);
-        std::swap(s.capacity_, capacity_);
-        std::swap(s.str_, str_);
+        char tmp[sizeof(small_)];
+        memcpy(tmp, small_, sizeof(small_));
+        memcpy(small_, s.small_, sizeof(small_));
+        memcpy(s.small_, tmp, sizeof(small_));
     }
 
+    // A valid index past the inline capacity can only address a heap string, so such
+    // indices skip the tag check; this also keeps GCC from reporting -Warray-bounds for
+    // constant indices into the inline buffer on a path that can never run
     char &operator[](const size_t i)
     {
-        return str_[i];
+        return (i < kSmallCapacity && isSmall()) ? small_[i] : heap_.str[i];
     }
 
     const char &operator[](const size_t i) const
     {
-        return str_[i];
+        return (i < kSmallCapacity && isSmall()) ? small_[i] : heap_.str[i];
     }
 
     size_t length() const
     {
-        return sz_;
+        return isSmall() ? static_cast<size_t>(small_[kSmallCapacity]) : heap_.sz;
     }
 
     String substr(const size_t &start, const size_t &count) const
     {
         String ans(count);
-        memcpy(ans.str_, str_ + start, count);
+        memcpy(ans.data(), data() + start, count);
         return ans;
     }
 
     void clear()
     {
-        delete[] str_;
-        str_ = nullptr;
-        capacity_ = 0;
-        sz_ = 0;
+        release();
     }
 
     bool empty() const
     {
-        return (sz_ == 0);
+        return (length() == 0);
     }
 
-    size_t find(const String &t) const
+    // View of characters [start, start + count) without copying them; it is invalidated by
+    // anything that reallocates or destroys this String
+    StringView view(const size_t start, const size_t count) const
     {
-        bool flag = false;
-        size_t find = sz_;
-        for (size_t i = 0; i < sz_; ++i)
-        {
-            if (str_[i] == t[0])
-            {
-                flag = true;
-                find = i;
-                for (size_t sub_i = 0; sub_i < t.sz_ && i < sz_; ++sub_i)
-                {
-                    if (t[sub_i] != str_[i])
-                    {
-                        flag = false;
-                        break;
-                    }
-                    ++i;
-                }
-                if (i - find < t.sz_)
-                {
-                    flag = false;
-                }
-                if (!flag)
-                {
-                    find = sz_;
-                }
-            }
-            if (flag && i - find == t.sz_)
-            {
-                return find;
-            }
-        }
-        return find;
+        return StringView(data() + start, count);
     }
 
-    size_t rfind(const String &t) const
+    operator StringView() const
     {
-        bool flag = false;
-        size_t find = sz_;
-        for (size_t i = 0; i < sz_; ++i)
-        {
-            if (str_[i] == t[0])
-            {
-                flag = true;
-                size_t cur = i;
-                size_t j = i;
-                for (size_t sub_i = 0; sub_i < t.sz_ && j < sz_; ++sub_i)
-                {
-                    if (t[sub_i] != str_[j])
-                    {
-                        flag = false;
-                        break;
-                    }
-                    ++j;
-                }
-                if (j - cur == t.sz_ && flag)
-                {
-                    find = cur;
-                }
-            }
-        }
-        return find;
+        return StringView(data(), length());
+    }
+
+    // Position of the first occurrence of t at or after pos, length() if there is none
+    size_t find(StringView t, size_t pos = 0) const
+    {
+        return StringSearch::find(data(), length(), t.data(), t.length(), pos);
+    }
+
+    // Position of the last occurrence of t starting at or before pos, length() if there is none
+    size_t rfind(StringView t, size_t pos = static_cast<size_t>(-1)) const
+    {
+        return StringSearch::rfind(data(), length(), t.data(), t.length(), pos);
+    }
+
+    // Single-character searches, as find(String(c)) and rfind(String(c)) without the copy
+    size_t find(char c, size_t pos = 0) const
+    {
+        return StringSearch::find(data(), length(), &c, 1, pos);
+    }
+
+    size_t rfind(char c, size_t pos = static_cast<size_t>(-1)) const
+    {
+        return StringSearch::rfind(data(), length(), &c, 1, pos);
     }
 
     const char &front() const
     {
-        return str_[0];
+        return data()[0];
     }
 
     const char &back() const
     {
-        return str_[sz_ - 1];
+        return data()[length() - 1];
     }
 
     char &front()
     {
-        return str_[0];
+        return data()[0];
     }
 
     char &back()
     {
-        return str_[sz_ - 1];
+        return data()[length() - 1];
     }
 
     void pop_back()
     {
-        if (sz_ == capacity_ / 4 && sz_ != 0)
+        size_t sz = length();
+        if (!isSmall() && sz == capacity() / 4 && sz != 0)
         {
             decreaseCapacity();
         }
-        str_[sz_ - 1] = '\0';
-        --sz_;
+        data()[sz - 1] = '\0';
+        setSize(sz - 1);
     }
 
     void push_back(const char &c)
@@ -224,45 +690,31 @@ public:
 
     String &operator+=(const String &s)
     {
-        if (s.sz_ + sz_ >= capacity_)
-        {
-            increaseCapacity(std::max(s.sz_, sz_));
-        }
-        for (size_t i = 0; i < s.sz_; ++i)
-        {
-            str_[i + sz_] = s[i];
-        }
-        sz_ += s.sz_;
+        append(s.data(), s.length());
+        return *this;
+    }
+
+    String &operator+=(StringView s)
+    {
+        append(s.data(), s.length());
         return *this;
     }
 
     String &operator+=(const char *s)
     {
-        size_t len_s = strlen(s);
-        if (sz_ + len_s >= capacity_)
-        {
-            increaseCapacity(std::max(len_s, sz_));
-        }
-        for (size_t i = 0; i < len_s; ++i)
-        {
-            str_[i + sz_] = s[i];
-        }
-        sz_ += len_s;
+        append(s, strlen(s));
         return *this;
     }
 
     String &operator+=(const char c)
     {
-        if (sz_ >= capacity_)
-        {
-            increaseCapacity(capacity_);
-        }
-        str_[sz_] = c;
-        ++sz_;
+        append(&c, 1);
         return *this;
     }
 };
 
+static_assert(sizeof(String) == 3 * sizeof(char *), "String must stay three words wide");
+
 String operator+(const String &a, const String &b)
 {
     String res = a;
@@ -270,61 +722,99 @@ String operator+(const String &a, const String &b)
     return res;
 }
 
-bool operator==(const String &a, const String &b)
+// Comparisons take views, so String, StringView and string literals mix without copies
+bool operator==(StringView a, StringView b)
 {
-    if (a.length() != b.length())
-    {
-        return false;
-    }
-    else
-    {
-        for (size_t i = 0; i < a.length(); ++i)
-        {
-            if (a[i] != b[i])
-            {
-                return false;
-            }
-        }
-        return true;
-    }
+    return a.length() == b.length() && (a.length() == 0 || memcmp(a.data(), b.data(), a.length()) == 0);
 }
 
-bool operator<(const String &a, const String &b)
+bool operator!=(StringView a, StringView b)
 {
-    for (size_t i = 0; i < std::min(a.length(), b.length()); ++i)
-    {
-        if (a[i] < b[i])
-        {
-            return true;
-        }
-        else
-        {
-            return false;
-        }
-    }
-    if (a.length() < b.length())
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return !(a == b);
+}
+
+// Lexicographic by unsigned char, a proper prefix orders first
+bool operator<(StringView a, StringView b)
+{
+    size_t common = std::min(a.length(), b.length());
+    int res = (common == 0) ? 0 : memcmp(a.data(), b.data(), common);
+    return res < 0 || (res == 0 && a.length() < b.length());
 }
 
-bool operator>(const String &a, const String &b)
+bool operator>(StringView a, StringView b)
 {
     return (b < a);
 }
 
-bool operator<=(const String &a, const String &b)
+bool operator<=(StringView a, StringView b)
+{
+    return !(b < a);
+}
+
+bool operator>=(StringView a, StringView b)
+{
+    return !(a < b);
+}
+
+// A char compares as the one-character string, as it did through String's char constructor
+bool operator==(StringView a, char c)
+{
+    return a == StringView(&c, 1);
+}
+
+bool operator==(char c, StringView b)
+{
+    return StringView(&c, 1) == b;
+}
+
+bool operator!=(StringView a, char c)
+{
+    return a != StringView(&c, 1);
+}
+
+bool operator!=(char c, StringView b)
+{
+    return StringView(&c, 1) != b;
+}
+
+bool operator<(StringView a, char c)
 {
-    return (a < b || a == b);
+    return a < StringView(&c, 1);
 }
 
-bool operator>=(const String &a, const String &b)
+bool operator<(char c, StringView b)
 {
-    return (a > b || a == b);
+    return StringView(&c, 1) < b;
+}
+
+bool operator>(StringView a, char c)
+{
+    return a > StringView(&c, 1);
+}
+
+bool operator>(char c, StringView b)
+{
+    return StringView(&c, 1) > b;
+}
+
+bool operator<=(StringView a, char c)
+{
+    return a <= StringView(&c, 1);
+}
+
+bool operator<=(char c, StringView b)
+{
+    return StringView(&c, 1) <= b;
+}
+
+bool operator>=(StringView a, char c)
+{
+    return a >= StringView(&c, 1);
+}
+
+bool operator>=(char c, StringView b)
+{
+    return StringView(&c, 1) >= b;
 }
 
 std::ostream &operator<<(std::ostream &out, const String &s)
@@ -336,6 +826,11 @@ std::ostream &operator<<(std::ostream &out, const String &s)
     return out;
 }
 
+std::ostream &operator<<(std::ostream &out, StringView s)
+{
+    return out.write(s.data(), s.length());
+}
+
 std::istream &operator>>(std::istream &in, String &s)
 {
     s.clear();
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+#include "patternset.h"
+#include <string>
+#include <vector>
+
+TEST(PatternSet, FindAll)
+{
+    PatternSet set({"he", "she", "his", "hers", "s"});
+    ASSERT_EQ(set.size(), 5);
+    std::vector<PatternMatch> expected = {{1, 4}, {1, 1}, {2, 0}, {2, 3}, {5, 4}};
+    ASSERT_EQ(set.findAll("ushers"), expected);
+    ASSERT_TRUE(set.findAll("xyz").empty());
+    ASSERT_TRUE(set.findAll("").empty());
+    ASSERT_THROW(PatternSet({"a", ""}), std::invalid_argument);
+
+    // nested and duplicate patterns
+    PatternSet nested({"a", "aa", "aaa", "a"});
+    std::vector<PatternMatch> matches = nested.findAll("aaa");
+    ASSERT_EQ(matches.size(), 9);
+    ASSERT_EQ(matches.back(), (PatternMatch{2, 3}));
+}
+
+TEST(PatternSet, MatchesRepeatedFind)
+{
+    std::vector<String> patterns = {"error", "err", "timeout", "reset", "connect", "connection reset", "out", "e"};
+    PatternSet set(patterns);
+    String text = "connection reset by peer; upstream connect error or timeout, retrying after reset";
+    std::vector<size_t> count(patterns.size(), 0);
+    for (const PatternMatch &m : set.findAll(text))
+    {
+        ASSERT_EQ(text.substr(m.position, patterns[m.pattern].length()), patterns[m.pattern]);
+        ++count[m.pattern];
+    }
+    for (size_t p = 0; p < patterns.size(); ++p)
+    {
+        size_t expected = 0;
+        for (size_t pos = text.find(patterns[p]); pos < text.length(); pos = text.find(patterns[p], pos + 1))
+        {
+            ++expected;
+        }
+        ASSERT_EQ(count[p], expected);
+    }
+}
+
+TEST(PatternSet, StreamingAcrossChunks)
+{
+    // the binary pattern needs an explicit length, String(const char *) stops at the NUL
+    String binary(StringView("\xff\x00x", 3));
+    ASSERT_EQ(binary.length(), 3);
+    PatternSet set({"needle", "dle", binary});
+    std::string text = "hayneedle\xffhayneedle";
+    text += std::string("\xff\x00x", 3);
+    String whole(StringView(text.data(), text.size()));
+    std::vector<PatternMatch> expected = set.findAll(whole);
+    ASSERT_EQ(expected.size(), 5);
+    ASSERT_EQ(expected.back(), (PatternMatch{19, 2}));
+    ASSERT_EQ(whole.substr(19, 3), binary);
+    for (size_t chunk = 1; chunk <= text.size(); ++chunk)
+    {
+        PatternSet::Scanner scanner = set.scanner();
+        std::vector<PatternMatch> got;
+        for (size_t i = 0; i < text.size(); i += chunk)
+            scanner.feed(text.data() + i, std::min(chunk, text.size() - i), got);
+        ASSERT_EQ(got, expected);
+        ASSERT_EQ(scanner.offset(), text.size());
+    }
+}
@@ -170,6 +170,121 @@ TEST(FindAndSubstr, Positive)
     ASSERT_EQ(ss.front(), '3');
 }
 
+TEST(SmallString, InlineHeapBoundary)
+{
+    ASSERT_EQ(sizeof(String), 3 * sizeof(char *));
+    String s;
+    std::string expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        s += static_cast<char>('a' + i % 26);
+        expected += static_cast<char>('a' + i % 26);
+        ASSERT_EQ(s.length(), expected.size());
+        ASSERT_EQ(s.back(), expected.back());
+        ASSERT_EQ(s.front(), 'a');
+    }
+    for (int i = 0; i < 95; ++i)
+    {
+        s.pop_back();
+    }
+    ASSERT_EQ(s, "abcde");
+
+    String small("0123456789012345678901"), big(40, 'x');
+    ASSERT_EQ(small.length(), 22);
+    small.swap(big);
+    ASSERT_EQ(big, "0123456789012345678901");
+    ASSERT_EQ(small, String(40, 'x'));
+    big += big;
+    ASSERT_EQ(big.length(), 44);
+    ASSERT_EQ(big.substr(22, 22), "0123456789012345678901");
+    String moved = std::move(small);
+    ASSERT_EQ(moved.length(), 40);
+    ASSERT_TRUE(small.empty());
+    small = "short";
+    small += 'X';
+    ASSERT_EQ(small, "shortX");
+}
+
+TEST(FindAndSubstr, PositionsAndLongNeedles)
+{
+    const String s = "abracadabra abracadabra";
+    ASSERT_EQ(s.find("abra"), 0);
+    ASSERT_EQ(s.find("abra", 1), 7);
+    ASSERT_EQ(s.find("abra", 20), s.length());
+    ASSERT_EQ(s.rfind("abra"), 19);
+    ASSERT_EQ(s.rfind("abra", 18), 12);
+    ASSERT_EQ(s.rfind("abra", 0), 0);
+    ASSERT_EQ(s.find("aab"), s.length());
+    ASSERT_EQ(String("aaab").find("aab"), 1);
+    ASSERT_EQ(s.find(""), 0);
+    ASSERT_EQ(s.rfind(""), s.length());
+
+    // needles above the prefilter size go through Two-Way, periodic and not
+    String text(1000, 'a');
+    String periodic(100, 'a'), tail = String(60, 'a') + "b";
+    ASSERT_EQ(text.find(periodic), 0);
+    ASSERT_EQ(text.find(periodic, 550), 550);
+    ASSERT_EQ(text.rfind(periodic), 900);
+    ASSERT_EQ(text.rfind(periodic, 300), 300);
+    ASSERT_EQ(text.find(tail), text.length());
+    text[700] = 'b';
+    ASSERT_EQ(text.find(tail), 640);
+    ASSERT_EQ(text.rfind(tail), 640);
+    ASSERT_EQ(text.find(tail, 641), text.length());
+    String log = String(5000, '.') + "upstream connect error or disconnect/reset before headers" + String(10, '.');
+    ASSERT_EQ(log.find("upstream connect error or disconnect/reset before headers"), 5000);
+    ASSERT_EQ(log.rfind("upstream connect error or disconnect/reset before headers"), 5000);
+}
+
+TEST(StringView, SlicesWithoutCopies)
+{
+    String s = "key=value; other=thing";
+    StringView key = s.view(0, 3), rest = s.view(4, 18);
+    ASSERT_EQ(key.data(), &s[0]);
+    ASSERT_EQ(key, "key");
+    ASSERT_EQ(rest.find(";"), 5);
+    ASSERT_EQ(rest.substr(0, 5), "value");
+    ASSERT_EQ(rest.rfind("t"), 13);
+    ASSERT_EQ(s.find(rest.substr(7, 5)), 11);
+    ASSERT_EQ(String(rest.substr(7, 5)), "other");
+
+    String built;
+    built += key;
+    built += StringView(":", 1);
+    built += rest.substr(0, 5);
+    ASSERT_EQ(built, "key:value");
+
+    ASSERT_TRUE(StringView("abc") < StringView("abd"));
+    ASSERT_TRUE(String("ab") < "abc");
+    ASSERT_TRUE(String("b") > "abc");
+    ASSERT_FALSE(String("abc") <= "ab");
+    ASSERT_TRUE(s.view(0, 3) != "kez");
+    ASSERT_TRUE(StringView() == String());
+
+    String a = "a";
+    ASSERT_TRUE(a == 'a');
+    ASSERT_TRUE('a' == a);
+    ASSERT_TRUE(a != 'b');
+    ASSERT_TRUE(a < 'b');
+    ASSERT_TRUE('b' > a);
+    ASSERT_TRUE(String("ab") > 'a');
+    ASSERT_FALSE(String() == 'a');
+    ASSERT_TRUE(key.substr(0, 1) == 'k');
+
+    String hello = "hello world";
+    ASSERT_EQ(hello.find('l'), 2);
+    ASSERT_EQ(hello.find('l', 4), 9);
+    ASSERT_EQ(hello.rfind('l'), 9);
+    ASSERT_EQ(hello.rfind('l', 8), 3);
+    ASSERT_EQ(hello.find('z'), hello.length());
+    ASSERT_EQ(StringView(hello).find('o'), 4);
+    ASSERT_EQ(StringView(hello).rfind('o'), 7);
+
+    std::ostringstream oss;
+    oss << s.view(4, 5);
+    ASSERT_EQ(oss.str(), "value");
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();